@@ -90,13 +90,13 @@ void _irq_priority_set(unsigned int irq, unsigned int prio, uint32_t flags)
 	 */
 
 #if CONFIG_ZERO_LATENCY_IRQS
-	/* If we have zero latency interrupts, that makes priority level 2
-	 * a case with special semantics; it is not masked by irq_lock().
-	 * Our policy is to express priority levels with special properties
-	 * via flags
+	/* If we have zero latency interrupts, they get the priority level
+	 * right above the ones masked by irq_lock(), which start at
+	 * _IRQ_PRIO_OFFSET. Our policy is to express priority levels with
+	 * special properties via flags
 	 */
 	if (flags & IRQ_ZERO_LATENCY) {
-		prio = 2;
+		prio = _IRQ_PRIO_OFFSET - 1;
 	} else {
 		prio += _IRQ_PRIO_OFFSET;
 	}
@@ -10,6 +10,7 @@ import sys
 import os
 
 ISR_FLAG_DIRECT = (1 << 0)
+ISR_FLAG_ZERO_LATENCY = (1 << 1)
 
 def debug(text):
     if not args.debug:
@@ -171,6 +172,12 @@ def main():
         swt = None
 
     for irq, flags, func, param in intlist["interrupts"]:
+        # The SW ISR table wrapper runs kernel code, which zero latency
+        # interrupts may preempt at any point
+        if (flags & ISR_FLAG_ZERO_LATENCY) and not (flags & ISR_FLAG_DIRECT):
+            error("Zero latency irq %d has to be connected with "
+                    "IRQ_DIRECT_CONNECT()" % irq)
+
         if (flags & ISR_FLAG_DIRECT):
             if (param != 0):
                 error("Direct irq %d declared, but has non-NULL parameter"
@@ -7,6 +7,7 @@
 #include <toolchain.h>
 #include <kernel_structs.h>
 #include <misc/printk.h>
+#include <misc/__assert.h>
 
 void _irq_spurious(void *unused)
 {
@@ -22,3 +23,76 @@ void _irq_spurious(void *unused)
 
 	_NanoFatalErrorHandler(_NANO_ERR_SPURIOUS_INT, &_default_esf);
 }
+
+#if defined(CONFIG_RISCV_NESTED_IRQ)
+BUILD_ASSERT(CONFIG_NUM_IRQS <= 32);
+
+/* Priority of each IRQ line, lines never connected are the least urgent */
+static uint8_t irq_prio[CONFIG_NUM_IRQS] = {
+	[0 ... (CONFIG_NUM_IRQS - 1)] = UINT8_MAX,
+};
+
+/* IRQ lines allowed to preempt the ISR of each line */
+static uint32_t irq_preempt[CONFIG_NUM_IRQS];
+
+/**
+ *
+ * @brief Set an interrupt's priority
+ *
+ * Only lines of a strictly lower priority value, i.e. more urgent, may
+ * preempt the ISR of @a irq.
+ *
+ * @return N/A
+ */
+void _irq_priority_set(unsigned int irq, unsigned int prio, uint32_t flags)
+{
+	unsigned int key, i;
+
+	ARG_UNUSED(flags);
+
+	__ASSERT(irq < CONFIG_NUM_IRQS, "invalid IRQ %d\n", irq);
+	__ASSERT(prio < UINT8_MAX, "invalid priority %d\n", prio);
+
+	key = irq_lock();
+
+	irq_prio[irq] = prio;
+
+	for (i = 0; i < CONFIG_NUM_IRQS; i++) {
+		if (irq_prio[i] < prio) {
+			irq_preempt[irq] |= (1 << i);
+		} else {
+			irq_preempt[irq] &= ~(1 << i);
+		}
+
+		if (prio < irq_prio[i]) {
+			irq_preempt[i] |= (1 << irq);
+		} else {
+			irq_preempt[i] &= ~(1 << irq);
+		}
+	}
+
+	irq_unlock(key);
+}
+
+/*
+ * Called by the ISR wrapper, with interrupts locked, before running the
+ * ISR of @a irq: mask the lines which may not preempt it and unlock
+ * interrupts. Returns the lines masked, for _riscv_irq_nest_exit.
+ */
+uint32_t _riscv_irq_nest_enter(unsigned int irq)
+{
+	uint32_t masked;
+
+	masked = soc_irq_mask(~irq_preempt[irq]);
+	_arch_irq_unlock(SOC_MSTATUS_IEN);
+
+	return masked;
+}
+
+/* Called by the ISR wrapper once the ISR returned */
+void _riscv_irq_nest_exit(uint32_t masked)
+{
+	(void)_arch_irq_lock();
+	soc_irq_unmask(masked);
+}
+#endif /* CONFIG_RISCV_NESTED_IRQ */
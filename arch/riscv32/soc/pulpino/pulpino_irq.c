@@ -50,3 +50,20 @@ void soc_interrupt_init(void)
 	PULP_EER = 0;
 }
 #endif
+
+#if defined(CONFIG_RISCV_NESTED_IRQ)
+/* Called with interrupts locked */
+uint32_t soc_irq_mask(uint32_t lines)
+{
+	uint32_t masked = PULP_IER & lines;
+
+	PULP_IER &= ~lines;
+
+	return masked;
+}
+
+void soc_irq_unmask(uint32_t lines)
+{
+	PULP_IER |= lines;
+}
+#endif
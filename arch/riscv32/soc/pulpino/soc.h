@@ -58,6 +58,16 @@
 /* SOC-Specific EXIT ISR command */
 #define SOC_ERET                   eret
 
+/*
+ * Inline interrupt check for the ISR entry: exception numbers from
+ * PULP_MIN_IRQ on are interrupts.
+ */
+#define SOC_IS_IRQ(reg, tmp)                \
+	csrr tmp, mcause;                   \
+	andi tmp, tmp, SOC_MCAUSE_EXP_MASK; \
+	sltiu reg, tmp, PULP_MIN_IRQ;       \
+	xori reg, reg, 1
+
 /* UART configuration */
 #define UART_NS16550_PORT_0_BASE_ADDR     0x1A100000
 #define UART_NS16550_PORT_0_CLK_FREQ      2500000
@@ -128,6 +138,16 @@
 void soc_interrupt_init(void);
 #endif
 
+#if defined(CONFIG_RISCV_NESTED_IRQ)
+/*
+ * Disable the given IRQ lines, returning those which were enabled, and
+ * enable them back. Used to keep lower priority interrupts from preempting
+ * an ISR.
+ */
+uint32_t soc_irq_mask(uint32_t lines);
+void soc_irq_unmask(uint32_t lines);
+#endif
+
 /*
  * when a generic riscv32 toolchain is used replaced wfi by sret
  * in inline assembly. Explanation given above.
@@ -60,3 +60,25 @@ void soc_interrupt_init(void)
 			  "csrwi sip, 0\n");
 }
 #endif
+
+#if defined(CONFIG_RISCV_NESTED_IRQ)
+uint32_t soc_irq_mask(uint32_t lines)
+{
+	uint32_t mie;
+
+	__asm__ volatile ("csrrc %0, mie, %1\n"
+			  : "=r" (mie)
+			  : "r" (lines));
+
+	return mie & lines;
+}
+
+void soc_irq_unmask(uint32_t lines)
+{
+	uint32_t mie;
+
+	__asm__ volatile ("csrrs %0, mie, %1\n"
+			  : "=r" (mie)
+			  : "r" (lines));
+}
+#endif
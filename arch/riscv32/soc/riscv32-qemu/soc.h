@@ -22,6 +22,17 @@
 #define RISCV_MTIME_BASE             0x40000000
 #define RISCV_MTIMECMP_BASE          0x40000008
 
+/*
+ * Inline interrupt check for the ISR entry: the exception is an interrupt
+ * if the bit of its number is pending in mip. srl only uses the low 5 bits
+ * of mcause, so the exception number needs no masking.
+ */
+#define SOC_IS_IRQ(reg, tmp)                \
+	csrr tmp, mcause;                   \
+	csrr reg, mip;                      \
+	srl reg, reg, tmp;                  \
+	andi reg, reg, 1
+
 /* lib-c hooks required RAM defined variables */
 #define RISCV_RAM_BASE             CONFIG_RISCV_RAM_BASE_ADDR
 #define RISCV_RAM_SIZE             MB(CONFIG_RISCV_RAM_SIZE_MB)
@@ -33,6 +44,16 @@
 void soc_interrupt_init(void);
 #endif
 
+#if defined(CONFIG_RISCV_NESTED_IRQ)
+/*
+ * Disable the given IRQ lines, returning those which were enabled, and
+ * enable them back. Used to keep lower priority interrupts from preempting
+ * an ISR.
+ */
+uint32_t soc_irq_mask(uint32_t lines);
+void soc_irq_unmask(uint32_t lines);
+#endif
+
 #endif /* !_ASMLANGUAGE */
 
 #endif /* __RISCV32_QEMU_SOC_H_ */
@@ -38,13 +38,14 @@
 #define MBEDTLS_NO_DEFAULT_ENTROPY_SOURCES
 #define MBEDTLS_PLATFORM_PRINTF_ALT
 
-#if !defined(CONFIG_ARM)
+#if !defined(CONFIG_ARM) || defined(CONFIG_MBEDTLS_ARM_ASM)
 #define MBEDTLS_HAVE_ASM
 #endif
 
 #if defined(CONFIG_MBEDTLS_TEST)
 #define MBEDTLS_SELF_TEST
 #define MBEDTLS_DEBUG_C
+#define MBEDTLS_MEMORY_DEBUG
 #else
 #define MBEDTLS_ENTROPY_C
 #endif
@@ -72,6 +73,7 @@
 #define MBEDTLS_RSA_C
 #define MBEDTLS_SHA1_C
 #define MBEDTLS_SHA256_C
+#define MBEDTLS_SSL_CACHE_C
 #define MBEDTLS_SSL_CLI_C
 #define MBEDTLS_SSL_SRV_C
 #define MBEDTLS_SSL_TLS_C
@@ -44,7 +44,12 @@
 #define MBEDTLS_NO_DEFAULT_ENTROPY_SOURCES
 #define MBEDTLS_PLATFORM_PRINTF_ALT
 
-#if !defined(CONFIG_ARM)
+#if defined(CONFIG_MBEDTLS_THREADING)
+#define MBEDTLS_THREADING_C
+#define MBEDTLS_THREADING_ALT
+#endif
+
+#if !defined(CONFIG_ARM) || defined(CONFIG_MBEDTLS_ARM_ASM)
 #define MBEDTLS_HAVE_ASM
 #endif
 
@@ -59,6 +64,9 @@
 #define MBEDTLS_AES_ROM_TABLES
 #define MBEDTLS_ECP_DP_SECP256R1_ENABLED
 #define MBEDTLS_ECP_NIST_OPTIM
+#if defined(CONFIG_MBEDTLS_ECP_POOL)
+#define MBEDTLS_ECP_KEYPAIR_SOURCE
+#endif
 #define MBEDTLS_KEY_EXCHANGE_ECJPAKE_ENABLED
 #define MBEDTLS_SSL_MAX_FRAGMENT_LENGTH
 #define MBEDTLS_SSL_PROTO_TLS1_2
@@ -65,6 +65,25 @@ int mbedtls_aesni_crypt_ecb( mbedtls_aes_context *ctx,
                      const unsigned char input[16],
                      unsigned char output[16] );
 
+/**
+ * \brief          AES-NI AES-ECB en(de)cryption of four blocks at once
+ *
+ * \param ctx      AES context
+ * \param mode     MBEDTLS_AES_ENCRYPT or MBEDTLS_AES_DECRYPT
+ * \param input    64-byte input buffer (four independent blocks)
+ * \param output   64-byte output buffer (four independent blocks)
+ *
+ * \note           The blocks are interleaved round by round, which keeps
+ *                 the AES unit busy. Use it for modes where blocks do not
+ *                 depend on each other (CTR, GCM, CBC decryption).
+ *
+ * \return         0 on success (cannot fail)
+ */
+int mbedtls_aesni_crypt_ecb4( mbedtls_aes_context *ctx,
+                      int mode,
+                      const unsigned char input[64],
+                      unsigned char output[64] );
+
 /**
  * \brief          GCM multiplication: c = a * b in GF(2^128)
  *
@@ -79,6 +98,21 @@ void mbedtls_aesni_gcm_mult( unsigned char c[16],
                      const unsigned char a[16],
                      const unsigned char b[16] );
 
+/**
+ * \brief          Aggregated GCM multiplication:
+ *                 c = a0 * b0 + a1 * b1 + a2 * b2 + a3 * b3 in GF(2^128)
+ *
+ * \param c        Result
+ * \param a        First operands (four 16-byte elements)
+ * \param b        Second operands (four 16-byte elements)
+ *
+ * \note           Used to hash four blocks with one reduction, with b
+ *                 holding H^4, H^3, H^2 and H.
+ */
+void mbedtls_aesni_gcm_mult4( unsigned char c[16],
+                      const unsigned char a[64],
+                      const unsigned char b[64] );
+
 /**
  * \brief           Compute decryption round keys from encryption round keys
  *
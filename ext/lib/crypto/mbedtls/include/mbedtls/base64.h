@@ -70,6 +70,9 @@ int mbedtls_base64_encode( unsigned char *dst, size_t dlen, size_t *olen,
  *
  * \note           Call this function with *dst = NULL or dlen = 0 to obtain
  *                 the required buffer size in *olen
+ *
+ * \note           dst may be equal to src: the output never overtakes the
+ *                 input, so a buffer can be decoded in place.
  */
 int mbedtls_base64_decode( unsigned char *dst, size_t dlen, size_t *olen,
                    const unsigned char *src, size_t slen );
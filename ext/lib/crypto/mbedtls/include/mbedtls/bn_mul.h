@@ -629,6 +629,53 @@
            "r6", "r7", "r8", "r9", "cc"         \
          );
 
+#elif defined(__ARM_FEATURE_DSP) && ( __ARM_FEATURE_DSP == 1 ) && \
+      defined(__ARM_ARCH) && ( __ARM_ARCH >= 6 )
+
+/*
+ * ARMv6 and ARMv7E-M (Cortex-M4/M7): UMAAL does d + b * s + c in a
+ * single instruction. Registers are left to the compiler so that r7 can
+ * stay the Thumb frame pointer.
+ */
+#define MULADDC_INIT                            \
+    asm(
+
+#define MULADDC_CORE                            \
+            "ldr    r0, [%0], #4        \n\t"   \
+            "ldr    r1, [%1]            \n\t"   \
+            "umaal  r1, %2, %3, r0      \n\t"   \
+            "str    r1, [%1], #4        \n\t"
+
+#define MULADDC_STOP                            \
+         : "=r" (s),  "=r" (d), "=r" (c)        \
+         : "r" (b), "0" (s), "1" (d), "2" (c)   \
+         : "r0", "r1", "memory"                 \
+         );
+
+#elif defined(__thumb2__)
+
+/*
+ * Thumb-2 without the DSP extension (Cortex-M3): same as the ARM code
+ * below, without hard-coding r7.
+ */
+#define MULADDC_INIT                            \
+    asm(
+
+#define MULADDC_CORE                            \
+            "ldr    r0, [%0], #4        \n\t"   \
+            "mov    r1, #0              \n\t"   \
+            "ldr    r2, [%1]            \n\t"   \
+            "umlal  %2, r1, %3, r0      \n\t"   \
+            "adds   r2, r2, %2          \n\t"   \
+            "adc    %2, r1, #0          \n\t"   \
+            "str    r2, [%1], #4        \n\t"
+
+#define MULADDC_STOP                            \
+         : "=r" (s),  "=r" (d), "=r" (c)        \
+         : "r" (b), "0" (s), "1" (d), "2" (c)   \
+         : "r0", "r1", "r2", "memory", "cc"     \
+         );
+
 #else
 
 #define MULADDC_INIT                                    \
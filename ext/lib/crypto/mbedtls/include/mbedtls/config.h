@@ -463,6 +463,18 @@
  */
 #define MBEDTLS_ECP_NIST_OPTIM
 
+/**
+ * \def MBEDTLS_ECP_KEYPAIR_SOURCE
+ *
+ * Enable mbedtls_ecp_set_keypair_source(), which lets the application
+ * supply precomputed key pairs for the conventional base point of a group.
+ * Ephemeral ECDH keys and the ECJPAKE round one values can then come from a
+ * pool filled ahead of time instead of being computed during the handshake.
+ *
+ * Uncomment this macro to enable the key pair source hook.
+ */
+//#define MBEDTLS_ECP_KEYPAIR_SOURCE
+
 /**
  * \def MBEDTLS_ECDSA_DETERMINISTIC
  *
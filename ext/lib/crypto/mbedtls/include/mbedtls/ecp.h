@@ -607,6 +607,37 @@ int mbedtls_ecp_gen_keypair_base( mbedtls_ecp_group *grp,
                      int (*f_rng)(void *, unsigned char *, size_t),
                      void *p_rng );
 
+#if defined(MBEDTLS_ECP_KEYPAIR_SOURCE)
+/**
+ * \brief           Key pair source callback
+ *
+ * \param p_source  Source parameter
+ * \param grp       ECP group the key pair is requested for
+ * \param d         Destination MPI (secret part)
+ * \param Q         Destination point (public part), d times grp->G
+ *
+ * \return          0 if a key pair was written to d and Q, or a non-zero
+ *                  value to have the caller generate the key pair itself
+ */
+typedef int (*mbedtls_ecp_keypair_source_t)( void *p_source,
+                                             const mbedtls_ecp_group *grp,
+                                             mbedtls_mpi *d,
+                                             mbedtls_ecp_point *Q );
+
+/**
+ * \brief           Set the source of precomputed key pairs
+ *
+ * \param f_source  Source function, or NULL to always generate key pairs
+ * \param p_source  Source parameter
+ *
+ * \note            mbedtls_ecp_gen_keypair_base() consults the source only
+ *                  when G is the conventional base point of the group. Each
+ *                  key pair handed out must be fresh and used only once.
+ */
+void mbedtls_ecp_set_keypair_source( mbedtls_ecp_keypair_source_t f_source,
+                                     void *p_source );
+#endif /* MBEDTLS_ECP_KEYPAIR_SOURCE */
+
 /**
  * \brief           Generate a keypair
  *
@@ -92,6 +92,33 @@ int mbedtls_pem_read_buffer( mbedtls_pem_context *ctx, const char *header, const
                      const unsigned char *pwd,
                      size_t pwdlen, size_t *use_len );
 
+/**
+ * \brief       Decode the first PEM block of a buffer in place, without
+ *              allocating memory.
+ *
+ *              The base64 payload is decoded over itself, so the DER data
+ *              ends up inside data and the PEM text is destroyed. Encrypted
+ *              PEM blocks are not supported.
+ *
+ * \param header    header string to seek and expect
+ * \param footer    footer string to seek and expect
+ * \param data      source data to look in, overwritten by the DER data
+ * \param data_len  length of data (need not be nul-terminated)
+ * \param der       destination for the start of the DER data within data
+ * \param der_len   destination for the length of the DER data
+ * \param use_len   destination for total length used (set after header is
+ *                  correctly read, so unless you get
+ *                  MBEDTLS_ERR_PEM_BAD_INPUT_DATA or
+ *                  MBEDTLS_ERR_PEM_NO_HEADER_FOOTER_PRESENT, use_len is
+ *                  the length to skip)
+ *
+ * \return          0 on success, or a specific PEM error code
+ */
+int mbedtls_pem_decode_inplace( const char *header, const char *footer,
+                                unsigned char *data, size_t data_len,
+                                unsigned char **der, size_t *der_len,
+                                size_t *use_len );
+
 /**
  * \brief       PEM context memory freeing
  *
@@ -51,6 +51,7 @@ extern "C" {
  */
 typedef struct mbedtls_x509_crt
 {
+    int own_buffer;                     /**< Indicates if raw is owned by the structure or not. */
     mbedtls_x509_buf raw;               /**< The raw certificate data (DER). */
     mbedtls_x509_buf tbs;               /**< The raw certificate body (DER). The part that is To Be Signed. */
 
@@ -173,6 +174,47 @@ extern const mbedtls_x509_crt_profile mbedtls_x509_crt_profile_suiteb;
 int mbedtls_x509_crt_parse_der( mbedtls_x509_crt *chain, const unsigned char *buf,
                         size_t buflen );
 
+/**
+ * \brief          Parse a single DER formatted certificate and add it
+ *                 to the chained list, without copying the DER data.
+ *
+ *                 The certificate keeps pointing into buf, which may be
+ *                 read-only memory such as DER data linked into flash.
+ *
+ * \param chain    points to the start of the chain
+ * \param buf      buffer holding the certificate DER data; must stay valid
+ *                 and unmodified until the certificate is freed
+ * \param buflen   size of the buffer
+ *
+ * \return         0 if successful, or a specific X509 or PEM error code
+ */
+int mbedtls_x509_crt_parse_der_nocopy( mbedtls_x509_crt *chain,
+                                       const unsigned char *buf,
+                                       size_t buflen );
+
+/**
+ * \brief          Parse one or more certificates from a writable buffer
+ *                 and add them to the chained list, without copying them.
+ *
+ *                 DER data is parsed where it is. PEM certificates are
+ *                 decoded in place, overwriting the PEM text, so no heap
+ *                 buffer is needed for the DER data. Encrypted PEM is not
+ *                 supported.
+ *
+ *                 The certificates keep pointing into buf, so it must stay
+ *                 valid and unmodified until they are freed.
+ *
+ * \param chain    points to the start of the chain
+ * \param buf      buffer holding the certificate data in PEM or DER format
+ * \param buflen   size of the buffer
+ *
+ * \return         0 if all certificates parsed successfully, a positive
+ *                 number if partly successful or a specific X509 or PEM
+ *                 error code
+ */
+int mbedtls_x509_crt_parse_inplace( mbedtls_x509_crt *chain,
+                                    unsigned char *buf, size_t buflen );
+
 /**
  * \brief          Parse one or more certificates and add them
  *                 to the chained list. Parses permissively. If some
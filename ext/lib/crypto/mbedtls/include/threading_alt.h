@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _THREADING_ALT_H_
+#define _THREADING_ALT_H_
+
+#include <kernel.h>
+
+/* Mutex type of MBEDTLS_THREADING_ALT, see zephyr_threading.c */
+typedef struct {
+	struct k_mutex mutex;
+	char is_valid;
+} mbedtls_threading_mutex_t;
+
+#endif /* _THREADING_ALT_H_ */
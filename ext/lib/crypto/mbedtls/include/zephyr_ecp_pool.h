@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _ZEPHYR_ECP_POOL_H_
+#define _ZEPHYR_ECP_POOL_H_
+
+#include "mbedtls/ecp.h"
+
+/**
+ * @brief Start pregenerating ephemeral key pairs
+ *
+ * Starts a thread that keeps up to CONFIG_MBEDTLS_ECP_POOL_SIZE key pairs of
+ * the given curve ready, and registers the pool as the mbed TLS key pair
+ * source. Key generation on that curve then takes a pool entry when one is
+ * available and falls back to computing the key pair otherwise.
+ *
+ * The pool thread runs at the lowest preemptible priority, so it only fills
+ * the pool while the application has nothing else to do. It generates the
+ * key pairs with its own DRBG, seeded and reseeded from the given RNG.
+ *
+ * Call this once, after the mbed TLS heap has been set up. The RNG context
+ * must stay valid until zephyr_ecp_pool_deinit() returns, and must be safe
+ * to use from another thread, as a CTR_DRBG context is with
+ * CONFIG_MBEDTLS_THREADING.
+ *
+ * @param grp_id Curve of the key pairs.
+ * @param f_rng RNG function seeding the pool DRBG.
+ * @param p_rng RNG parameter.
+ *
+ * @return 0 on success, an mbed TLS error code otherwise.
+ */
+int zephyr_ecp_pool_init(mbedtls_ecp_group_id grp_id,
+			 int (*f_rng)(void *, unsigned char *, size_t),
+			 void *p_rng);
+
+/**
+ * @brief Stop pregenerating key pairs
+ *
+ * Unregisters the key pair source, waits for the pool thread to finish
+ * the key pair it may be generating and stop, and frees the key pairs left
+ * in the pool. Call this before freeing the RNG context given to
+ * zephyr_ecp_pool_init(). It may be called even if zephyr_ecp_pool_init()
+ * was not or failed.
+ */
+void zephyr_ecp_pool_deinit(void);
+
+/**
+ * @brief Number of pregenerated key pairs currently available
+ */
+int zephyr_ecp_pool_count(void);
+
+#endif /* _ZEPHYR_ECP_POOL_H_ */
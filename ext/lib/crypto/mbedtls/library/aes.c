@@ -884,6 +884,35 @@ int mbedtls_aes_crypt_cbc( mbedtls_aes_context *ctx,
 
     if( mode == MBEDTLS_AES_DECRYPT )
     {
+#if defined(MBEDTLS_AESNI_C) && defined(MBEDTLS_HAVE_X86_64)
+        /*
+         * CBC decryption has no dependency between blocks, so let AES-NI
+         * work on four of them at once.
+         */
+        if( length >= 64 && mbedtls_aesni_has_support( MBEDTLS_AESNI_AES ) )
+        {
+            unsigned char temp4[64];
+
+            while( length >= 64 )
+            {
+                memcpy( temp4, input, 64 );
+                mbedtls_aesni_crypt_ecb4( ctx, mode, input, output );
+
+                for( i = 0; i < 16; i++ )
+                    output[i] = (unsigned char)( output[i] ^ iv[i] );
+
+                for( i = 16; i < 64; i++ )
+                    output[i] = (unsigned char)( output[i] ^ temp4[i - 16] );
+
+                memcpy( iv, temp4 + 48, 16 );
+
+                input  += 64;
+                output += 64;
+                length -= 64;
+            }
+        }
+#endif /* MBEDTLS_AESNI_C && MBEDTLS_HAVE_X86_64 */
+
         while( length > 0 )
         {
             memcpy( temp, input, 16 );
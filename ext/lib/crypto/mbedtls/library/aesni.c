@@ -88,6 +88,10 @@ int mbedtls_aesni_has_support( unsigned int what )
 #define xmm0_xmm4   "0xE0"
 #define xmm1_xmm0   "0xC1"
 #define xmm1_xmm2   "0xD1"
+#define xmm4_xmm0   "0xC4"
+#define xmm4_xmm1   "0xCC"
+#define xmm4_xmm2   "0xD4"
+#define xmm4_xmm3   "0xDC"
 
 /*
  * AES-NI AES-ECB block en(de)cryption
@@ -134,6 +138,77 @@ int mbedtls_aesni_crypt_ecb( mbedtls_aes_context *ctx,
     return( 0 );
 }
 
+/*
+ * AES-NI AES-ECB en(de)cryption of four independent blocks.
+ *
+ * The four blocks go through each round together so that the latency of
+ * one AESENC/AESDEC is hidden behind the three others ([AES-WP] p. 37).
+ */
+int mbedtls_aesni_crypt_ecb4( mbedtls_aes_context *ctx,
+                      int mode,
+                      const unsigned char input[64],
+                      unsigned char output[64] )
+{
+    int nr = ctx->nr;
+    const uint32_t *rk = ctx->rk;
+
+    asm volatile( "movdqu      (%3), %%xmm0  \n\t" // load input
+                  "movdqu    16(%3), %%xmm1  \n\t"
+                  "movdqu    32(%3), %%xmm2  \n\t"
+                  "movdqu    48(%3), %%xmm3  \n\t"
+                  "movdqu    (%1), %%xmm4    \n\t" // load round key 0
+                  "pxor      %%xmm4, %%xmm0  \n\t" // round 0
+                  "pxor      %%xmm4, %%xmm1  \n\t"
+                  "pxor      %%xmm4, %%xmm2  \n\t"
+                  "pxor      %%xmm4, %%xmm3  \n\t"
+                  "add       $16, %1         \n\t" // point to next round key
+                  "subl      $1, %0          \n\t" // normal rounds = nr - 1
+                  "test      %2, %2          \n\t" // mode?
+                  "jz        2f              \n\t" // 0 = decrypt
+
+                  "1:                        \n\t" // encryption loop
+                  "movdqu    (%1), %%xmm4    \n\t" // load round key
+                  AESENC     xmm4_xmm0      "\n\t" // do round
+                  AESENC     xmm4_xmm1      "\n\t"
+                  AESENC     xmm4_xmm2      "\n\t"
+                  AESENC     xmm4_xmm3      "\n\t"
+                  "add       $16, %1         \n\t" // point to next round key
+                  "subl      $1, %0          \n\t" // loop
+                  "jnz       1b              \n\t"
+                  "movdqu    (%1), %%xmm4    \n\t" // load round key
+                  AESENCLAST xmm4_xmm0      "\n\t" // last round
+                  AESENCLAST xmm4_xmm1      "\n\t"
+                  AESENCLAST xmm4_xmm2      "\n\t"
+                  AESENCLAST xmm4_xmm3      "\n\t"
+                  "jmp       3f              \n\t"
+
+                  "2:                        \n\t" // decryption loop
+                  "movdqu    (%1), %%xmm4    \n\t"
+                  AESDEC     xmm4_xmm0      "\n\t" // do round
+                  AESDEC     xmm4_xmm1      "\n\t"
+                  AESDEC     xmm4_xmm2      "\n\t"
+                  AESDEC     xmm4_xmm3      "\n\t"
+                  "add       $16, %1         \n\t"
+                  "subl      $1, %0          \n\t"
+                  "jnz       2b              \n\t"
+                  "movdqu    (%1), %%xmm4    \n\t" // load round key
+                  AESDECLAST xmm4_xmm0      "\n\t" // last round
+                  AESDECLAST xmm4_xmm1      "\n\t"
+                  AESDECLAST xmm4_xmm2      "\n\t"
+                  AESDECLAST xmm4_xmm3      "\n\t"
+
+                  "3:                        \n\t"
+                  "movdqu    %%xmm0,   (%4)  \n\t" // export output
+                  "movdqu    %%xmm1, 16(%4)  \n\t"
+                  "movdqu    %%xmm2, 32(%4)  \n\t"
+                  "movdqu    %%xmm3, 48(%4)  \n\t"
+                  : "+r" (nr), "+r" (rk)
+                  : "r" (mode), "r" (input), "r" (output)
+                  : "memory", "cc", "xmm0", "xmm1", "xmm2", "xmm3", "xmm4" );
+
+    return( 0 );
+}
+
 /*
  * GCM multiplication: c = a times b in GF(2^128)
  * Based on [CLMUL-WP] algorithms 1 (with equation 27) and 5.
@@ -246,6 +321,137 @@ void mbedtls_aesni_gcm_mult( unsigned char c[16],
     return;
 }
 
+/*
+ * Aggregated GCM multiplication: c = a0 * b0 + a1 * b1 + a2 * b2 + a3 * b3
+ *
+ * Carry-less multiplication, the one bit shift and the reduction are all
+ * linear, so the four 256-bit products are summed first and only the sum
+ * goes through the shift and reduction steps of mbedtls_aesni_gcm_mult().
+ */
+void mbedtls_aesni_gcm_mult4( unsigned char c[16],
+                      const unsigned char a[64],
+                      const unsigned char b[64] )
+{
+    unsigned char aa[64], bb[64], cc[16];
+    unsigned char *pa = aa, *pb = bb;
+    size_t i, j;
+    size_t n = 4;
+
+    /* The inputs are in big-endian order, so byte-reverse them */
+    for( j = 0; j < 64; j += 16 )
+    {
+        for( i = 0; i < 16; i++ )
+        {
+            aa[j + i] = a[j + 15 - i];
+            bb[j + i] = b[j + 15 - i];
+        }
+    }
+
+    asm volatile( "pxor %%xmm6, %%xmm6               \n\t" // low accumulator
+                  "pxor %%xmm7, %%xmm7               \n\t" // high accumulator
+
+                  "1:                                \n\t"
+                  "movdqu (%1), %%xmm0               \n\t" // a1:a0
+                  "movdqu (%2), %%xmm1               \n\t" // b1:b0
+
+                  /* Same multiplication as mbedtls_aesni_gcm_mult() */
+                  "movdqa %%xmm1, %%xmm2             \n\t"
+                  "movdqa %%xmm1, %%xmm3             \n\t"
+                  "movdqa %%xmm1, %%xmm4             \n\t"
+                  PCLMULQDQ xmm0_xmm1 ",0x00         \n\t" // a0*b0 = c1:c0
+                  PCLMULQDQ xmm0_xmm2 ",0x11         \n\t" // a1*b1 = d1:d0
+                  PCLMULQDQ xmm0_xmm3 ",0x10         \n\t" // a0*b1 = e1:e0
+                  PCLMULQDQ xmm0_xmm4 ",0x01         \n\t" // a1*b0 = f1:f0
+                  "pxor %%xmm3, %%xmm4               \n\t" // e1+f1:e0+f0
+                  "movdqa %%xmm4, %%xmm3             \n\t" // same
+                  "psrldq $8, %%xmm4                 \n\t" // 0:e1+f1
+                  "pslldq $8, %%xmm3                 \n\t" // e0+f0:0
+                  "pxor %%xmm4, %%xmm2               \n\t" // d1:d0+e1+f1
+                  "pxor %%xmm3, %%xmm1               \n\t" // c1+e0+f1:c0
+
+                  "pxor %%xmm1, %%xmm6               \n\t" // accumulate
+                  "pxor %%xmm2, %%xmm7               \n\t"
+                  "add $16, %1                       \n\t"
+                  "add $16, %2                       \n\t"
+                  "sub $1, %0                        \n\t"
+                  "jnz 1b                            \n\t"
+
+                  "movdqa %%xmm6, %%xmm1             \n\t"
+                  "movdqa %%xmm7, %%xmm2             \n\t"
+
+                  /*
+                   * Now shift the result one bit to the left,
+                   * taking advantage of [CLMUL-WP] eq 27 (p. 20)
+                   */
+                  "movdqa %%xmm1, %%xmm3             \n\t" // r1:r0
+                  "movdqa %%xmm2, %%xmm4             \n\t" // r3:r2
+                  "psllq $1, %%xmm1                  \n\t" // r1<<1:r0<<1
+                  "psllq $1, %%xmm2                  \n\t" // r3<<1:r2<<1
+                  "psrlq $63, %%xmm3                 \n\t" // r1>>63:r0>>63
+                  "psrlq $63, %%xmm4                 \n\t" // r3>>63:r2>>63
+                  "movdqa %%xmm3, %%xmm5             \n\t" // r1>>63:r0>>63
+                  "pslldq $8, %%xmm3                 \n\t" // r0>>63:0
+                  "pslldq $8, %%xmm4                 \n\t" // r2>>63:0
+                  "psrldq $8, %%xmm5                 \n\t" // 0:r1>>63
+                  "por %%xmm3, %%xmm1                \n\t" // r1<<1|r0>>63:r0<<1
+                  "por %%xmm4, %%xmm2                \n\t" // r3<<1|r2>>62:r2<<1
+                  "por %%xmm5, %%xmm2                \n\t" // r3<<1|r2>>62:r2<<1|r1>>63
+
+                  /*
+                   * Now reduce modulo the GCM polynomial x^128 + x^7 + x^2 + x + 1
+                   * using [CLMUL-WP] algorithm 5 (p. 20).
+                   * Currently xmm2:xmm1 holds x3:x2:x1:x0 (already shifted).
+                   */
+                  /* Step 2 (1) */
+                  "movdqa %%xmm1, %%xmm3             \n\t" // x1:x0
+                  "movdqa %%xmm1, %%xmm4             \n\t" // same
+                  "movdqa %%xmm1, %%xmm5             \n\t" // same
+                  "psllq $63, %%xmm3                 \n\t" // x1<<63:x0<<63 = stuff:a
+                  "psllq $62, %%xmm4                 \n\t" // x1<<62:x0<<62 = stuff:b
+                  "psllq $57, %%xmm5                 \n\t" // x1<<57:x0<<57 = stuff:c
+
+                  /* Step 2 (2) */
+                  "pxor %%xmm4, %%xmm3               \n\t" // stuff:a+b
+                  "pxor %%xmm5, %%xmm3               \n\t" // stuff:a+b+c
+                  "pslldq $8, %%xmm3                 \n\t" // a+b+c:0
+                  "pxor %%xmm3, %%xmm1               \n\t" // x1+a+b+c:x0 = d:x0
+
+                  /* Steps 3 and 4 */
+                  "movdqa %%xmm1,%%xmm0              \n\t" // d:x0
+                  "movdqa %%xmm1,%%xmm4              \n\t" // same
+                  "movdqa %%xmm1,%%xmm5              \n\t" // same
+                  "psrlq $1, %%xmm0                  \n\t" // e1:x0>>1 = e1:e0'
+                  "psrlq $2, %%xmm4                  \n\t" // f1:x0>>2 = f1:f0'
+                  "psrlq $7, %%xmm5                  \n\t" // g1:x0>>7 = g1:g0'
+                  "pxor %%xmm4, %%xmm0               \n\t" // e1+f1:e0'+f0'
+                  "pxor %%xmm5, %%xmm0               \n\t" // e1+f1+g1:e0'+f0'+g0'
+                  // e0'+f0'+g0' is almost e0+f0+g0, except for some missing
+                  // bits carried from d. Now get those bits back in.
+                  "movdqa %%xmm1,%%xmm3              \n\t" // d:x0
+                  "movdqa %%xmm1,%%xmm4              \n\t" // same
+                  "movdqa %%xmm1,%%xmm5              \n\t" // same
+                  "psllq $63, %%xmm3                 \n\t" // d<<63:stuff
+                  "psllq $62, %%xmm4                 \n\t" // d<<62:stuff
+                  "psllq $57, %%xmm5                 \n\t" // d<<57:stuff
+                  "pxor %%xmm4, %%xmm3               \n\t" // d<<63+d<<62:stuff
+                  "pxor %%xmm5, %%xmm3               \n\t" // missing bits of d:stuff
+                  "psrldq $8, %%xmm3                 \n\t" // 0:missing bits of d
+                  "pxor %%xmm3, %%xmm0               \n\t" // e1+f1+g1:e0+f0+g0
+                  "pxor %%xmm1, %%xmm0               \n\t" // h1:h0
+                  "pxor %%xmm2, %%xmm0               \n\t" // x3+h1:x2+h0
+
+                  "movdqu %%xmm0, (%3)               \n\t" // done
+                  : "+r" (n), "+r" (pa), "+r" (pb)
+                  : "r" (cc)
+                  : "memory", "cc", "xmm0", "xmm1", "xmm2", "xmm3",
+                    "xmm4", "xmm5", "xmm6", "xmm7" );
+
+    /* Now byte-reverse the outputs */
+    for( i = 0; i < 16; i++ )
+        c[i] = cc[15 - i];
+}
+
+
 /*
  * Compute decryption round keys from encryption round keys
  */
@@ -1809,6 +1809,21 @@ int mbedtls_ecp_check_privkey( const mbedtls_ecp_group *grp, const mbedtls_mpi *
     return( MBEDTLS_ERR_ECP_BAD_INPUT_DATA );
 }
 
+/*
+ * Optional source of precomputed key pairs
+ */
+#if defined(MBEDTLS_ECP_KEYPAIR_SOURCE)
+static mbedtls_ecp_keypair_source_t ecp_keypair_source = NULL;
+static void *ecp_keypair_source_ctx = NULL;
+
+void mbedtls_ecp_set_keypair_source( mbedtls_ecp_keypair_source_t f_source,
+                                     void *p_source )
+{
+    ecp_keypair_source = f_source;
+    ecp_keypair_source_ctx = p_source;
+}
+#endif /* MBEDTLS_ECP_KEYPAIR_SOURCE */
+
 /*
  * Generate a keypair with configurable base point
  */
@@ -1821,6 +1836,16 @@ int mbedtls_ecp_gen_keypair_base( mbedtls_ecp_group *grp,
     int ret;
     size_t n_size = ( grp->nbits + 7 ) / 8;
 
+#if defined(MBEDTLS_ECP_KEYPAIR_SOURCE)
+    /* Only Q = d.G for the conventional G can have been computed ahead */
+    if( ecp_keypair_source != NULL &&
+        mbedtls_ecp_point_cmp( G, &grp->G ) == 0 &&
+        ecp_keypair_source( ecp_keypair_source_ctx, grp, d, Q ) == 0 )
+    {
+        return( 0 );
+    }
+#endif
+
 #if defined(ECP_MONTGOMERY)
     if( ecp_get_type( grp ) == ECP_TYPE_MONTGOMERY )
     {
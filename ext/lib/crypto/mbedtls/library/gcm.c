@@ -344,6 +344,97 @@ int mbedtls_gcm_starts( mbedtls_gcm_context *ctx,
     return( 0 );
 }
 
+#if defined(MBEDTLS_AESNI_C) && defined(MBEDTLS_HAVE_X86_64) && \
+    defined(MBEDTLS_AES_C) && !defined(MBEDTLS_AES_ALT)
+/*
+ * Return the underlying AES context if the counter blocks can be encrypted
+ * and hashed four at a time with AES-NI and PCLMULQDQ, NULL otherwise.
+ */
+static mbedtls_aes_context *gcm_aesni_ctx( mbedtls_gcm_context *ctx )
+{
+    switch( mbedtls_cipher_get_type( &ctx->cipher_ctx ) )
+    {
+        case MBEDTLS_CIPHER_AES_128_ECB:
+        case MBEDTLS_CIPHER_AES_192_ECB:
+        case MBEDTLS_CIPHER_AES_256_ECB:
+            break;
+        default:
+            return( NULL );
+    }
+
+    if( ! mbedtls_aesni_has_support( MBEDTLS_AESNI_AES ) ||
+        ! mbedtls_aesni_has_support( MBEDTLS_AESNI_CLMUL ) )
+        return( NULL );
+
+    return( (mbedtls_aes_context *) ctx->cipher_ctx.cipher_ctx );
+}
+
+/*
+ * Process as many groups of four full blocks as possible: the key stream
+ * for a group comes from a single pipelined AES-NI call, and the group is
+ * folded into the hash with one aggregated multiplication,
+ *     X' = (X + C1) * H^4 + C2 * H^3 + C3 * H^2 + C4 * H
+ * Returns the number of bytes consumed.
+ */
+static size_t gcm_update_aesni4( mbedtls_gcm_context *ctx,
+                                 mbedtls_aes_context *aes,
+                                 size_t length,
+                                 const unsigned char *p,
+                                 unsigned char *out_p )
+{
+    unsigned char ectr[64];
+    unsigned char ghash[64];
+    unsigned char hpow[64];
+    size_t i, j, done = 0;
+
+    /* hpow = H^4 || H^3 || H^2 || H */
+    PUT_UINT32_BE( ctx->HH[8] >> 32, hpow, 48 );
+    PUT_UINT32_BE( ctx->HH[8],       hpow, 52 );
+    PUT_UINT32_BE( ctx->HL[8] >> 32, hpow, 56 );
+    PUT_UINT32_BE( ctx->HL[8],       hpow, 60 );
+    gcm_mult( ctx, hpow + 48, hpow + 32 );
+    gcm_mult( ctx, hpow + 32, hpow + 16 );
+    gcm_mult( ctx, hpow + 16, hpow );
+
+    while( length - done >= 64 )
+    {
+        for( j = 0; j < 64; j += 16 )
+        {
+            for( i = 16; i > 12; i-- )
+                if( ++ctx->y[i - 1] != 0 )
+                    break;
+
+            memcpy( ectr + j, ctx->y, 16 );
+        }
+
+        mbedtls_aesni_crypt_ecb4( aes, MBEDTLS_AES_ENCRYPT, ectr, ectr );
+
+        for( i = 0; i < 64; i++ )
+        {
+            if( ctx->mode == MBEDTLS_GCM_DECRYPT )
+                ghash[i] = p[i];
+            out_p[i] = ectr[i] ^ p[i];
+            if( ctx->mode == MBEDTLS_GCM_ENCRYPT )
+                ghash[i] = out_p[i];
+        }
+
+        for( i = 0; i < 16; i++ )
+            ghash[i] ^= ctx->buf[i];
+
+        mbedtls_aesni_gcm_mult4( ctx->buf, ghash, hpow );
+
+        done  += 64;
+        p     += 64;
+        out_p += 64;
+    }
+
+    mbedtls_zeroize( hpow, sizeof( hpow ) );
+    mbedtls_zeroize( ectr, sizeof( ectr ) );
+
+    return( done );
+}
+#endif /* MBEDTLS_AESNI_C && MBEDTLS_HAVE_X86_64 && MBEDTLS_AES_C */
+
 int mbedtls_gcm_update( mbedtls_gcm_context *ctx,
                 size_t length,
                 const unsigned char *input,
@@ -370,6 +461,24 @@ int mbedtls_gcm_update( mbedtls_gcm_context *ctx,
     ctx->len += length;
 
     p = input;
+
+#if defined(MBEDTLS_AESNI_C) && defined(MBEDTLS_HAVE_X86_64) && \
+    defined(MBEDTLS_AES_C) && !defined(MBEDTLS_AES_ALT)
+    if( length >= 64 )
+    {
+        mbedtls_aes_context *aes = gcm_aesni_ctx( ctx );
+
+        if( aes != NULL )
+        {
+            use_len = gcm_update_aesni4( ctx, aes, length, p, out_p );
+
+            length -= use_len;
+            p += use_len;
+            out_p += use_len;
+        }
+    }
+#endif
+
     while( length > 0 )
     {
         use_len = ( length < 16 ) ? length : 16;
@@ -383,6 +383,76 @@ int mbedtls_pem_read_buffer( mbedtls_pem_context *ctx, const char *header, const
     return( 0 );
 }
 
+/*
+ * Bounded strstr(): data handed to mbedtls_pem_decode_inplace() need not be
+ * nul-terminated, but a nul still ends the search like it does for strstr()
+ */
+static unsigned char *pem_find( unsigned char *s, const unsigned char *end,
+                                const char *str )
+{
+    size_t len = strlen( str );
+
+    for( ; (size_t)( end - s ) >= len && *s != '\0'; s++ )
+    {
+        if( memcmp( s, str, len ) == 0 )
+            return( s );
+    }
+
+    return( NULL );
+}
+
+int mbedtls_pem_decode_inplace( const char *header, const char *footer,
+                                unsigned char *data, size_t data_len,
+                                unsigned char **der, size_t *der_len,
+                                size_t *use_len )
+{
+    int ret;
+    size_t len;
+    unsigned char *s1, *s2, *end;
+    const unsigned char *data_end = data + data_len;
+
+    if( data == NULL || der == NULL || der_len == NULL || use_len == NULL )
+        return( MBEDTLS_ERR_PEM_BAD_INPUT_DATA );
+
+    s1 = pem_find( data, data_end, header );
+
+    if( s1 == NULL )
+        return( MBEDTLS_ERR_PEM_NO_HEADER_FOOTER_PRESENT );
+
+    s1 += strlen( header );
+    s2 = pem_find( s1, data_end, footer );
+
+    if( s2 == NULL )
+        return( MBEDTLS_ERR_PEM_NO_HEADER_FOOTER_PRESENT );
+
+    if( s1 < s2 && *s1 == ' '  ) s1++;
+    if( s1 < s2 && *s1 == '\r' ) s1++;
+    if( s1 < s2 && *s1 == '\n' ) s1++;
+    else return( MBEDTLS_ERR_PEM_NO_HEADER_FOOTER_PRESENT );
+
+    end = s2;
+    end += strlen( footer );
+    if( end < data_end && *end == ' '  ) end++;
+    if( end < data_end && *end == '\r' ) end++;
+    if( end < data_end && *end == '\n' ) end++;
+    *use_len = end - data;
+
+    if( s2 - s1 >= 22 && memcmp( s1, "Proc-Type: 4,ENCRYPTED", 22 ) == 0 )
+        return( MBEDTLS_ERR_PEM_FEATURE_UNAVAILABLE );
+
+    if( s1 == s2 )
+        return( MBEDTLS_ERR_PEM_INVALID_DATA );
+
+    /* Base64 output is shorter than its input, so decode over it */
+    if( ( ret = mbedtls_base64_decode( s1, s2 - s1, &len, s1, s2 - s1 ) ) != 0 )
+        return( MBEDTLS_ERR_PEM_INVALID_DATA + ret );
+
+    *der = s1;
+    *der_len = len;
+
+    return( 0 );
+}
+
 void mbedtls_pem_free( mbedtls_pem_context *ctx )
 {
     mbedtls_free( ctx->buf );
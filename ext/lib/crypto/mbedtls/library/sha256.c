@@ -36,6 +36,12 @@
 
 #include <string.h>
 
+#if !defined(MBEDTLS_SHA256_ALT) && !defined(MBEDTLS_SHA256_PROCESS_ALT) && \
+    defined(MBEDTLS_HAVE_ASM) && defined(__GNUC__) && defined(__x86_64__)
+#define MBEDTLS_SHA256_SHANI
+#include <immintrin.h>
+#endif
+
 #if defined(MBEDTLS_SELF_TEST)
 #if defined(MBEDTLS_PLATFORM_C)
 #include "mbedtls/platform.h"
@@ -179,12 +185,122 @@ static const uint32_t K[] =
     d += temp1; h = temp1 + temp2;              \
 }
 
+#if defined(MBEDTLS_SHA256_SHANI)
+/*
+ * x86 SHA extensions support detection routine
+ *
+ * SHA (CPUID.7.0:EBX[29]) plus SSSE3 and SSE4.1 (CPUID.1:ECX[9,19]) for
+ * the byte shuffles and blends around SHA256RNDS2.
+ */
+static int sha256_shani_support( void )
+{
+    static int done = 0;
+    static int support = 0;
+    unsigned int a, b, c, d;
+
+    if( ! done )
+    {
+        asm( "cpuid" : "=a" (a), "=b" (b), "=c" (c), "=d" (d) : "a" (0) );
+
+        if( a >= 7 )
+        {
+            asm( "cpuid" : "=a" (a), "=b" (b), "=c" (c), "=d" (d) : "a" (1) );
+            support = ( c & ( 1u << 9 ) ) != 0 && ( c & ( 1u << 19 ) ) != 0;
+
+            asm( "cpuid" : "=a" (a), "=b" (b), "=c" (c), "=d" (d)
+                         : "a" (7), "c" (0) );
+            support = support && ( b & ( 1u << 29 ) ) != 0;
+        }
+
+        done = 1;
+    }
+
+    return( support );
+}
+
+/*
+ * Process consecutive blocks with the SHA-NI instructions.
+ *
+ * The state is kept as ABEF/CDGH as expected by SHA256RNDS2; every group
+ * of four rounds also extends the message schedule by four words using
+ * SHA256MSG1/SHA256MSG2.
+ */
+__attribute__((target("sha,sse4.1")))
+static void sha256_process_shani( uint32_t state[8],
+                                  const unsigned char *data, size_t blocks )
+{
+    const __m128i mask = _mm_set_epi64x( 0x0c0d0e0f08090a0bULL,
+                                         0x0405060700010203ULL );
+    __m128i state0, state1, abef_save, cdgh_save, tmp;
+    __m128i msg[4];
+    unsigned int i;
+
+    tmp    = _mm_loadu_si128( (const __m128i *) &state[0] );
+    state1 = _mm_loadu_si128( (const __m128i *) &state[4] );
+    tmp    = _mm_shuffle_epi32( tmp, 0xB1 );             /* CDAB */
+    state1 = _mm_shuffle_epi32( state1, 0x1B );          /* EFGH */
+    state0 = _mm_alignr_epi8( tmp, state1, 8 );          /* ABEF */
+    state1 = _mm_blend_epi16( state1, tmp, 0xF0 );       /* CDGH */
+
+    while( blocks-- > 0 )
+    {
+        abef_save = state0;
+        cdgh_save = state1;
+
+        for( i = 0; i < 4; i++ )
+            msg[i] = _mm_shuffle_epi8(
+                        _mm_loadu_si128( (const __m128i *) ( data + 16 * i ) ),
+                        mask );
+
+        for( i = 0; i < 16; i++ )
+        {
+            tmp = _mm_add_epi32( msg[i & 3],
+                         _mm_loadu_si128( (const __m128i *) &K[4 * i] ) );
+            state1 = _mm_sha256rnds2_epu32( state1, state0, tmp );
+            tmp = _mm_shuffle_epi32( tmp, 0x0E );
+            state0 = _mm_sha256rnds2_epu32( state0, state1, tmp );
+
+            /* W[4i+16..4i+19] replaces W[4i..4i+3] */
+            if( i < 12 )
+            {
+                tmp = _mm_sha256msg1_epu32( msg[i & 3], msg[( i + 1 ) & 3] );
+                tmp = _mm_add_epi32( tmp, _mm_alignr_epi8( msg[( i + 3 ) & 3],
+                                                           msg[( i + 2 ) & 3],
+                                                           4 ) );
+                msg[i & 3] = _mm_sha256msg2_epu32( tmp, msg[( i + 3 ) & 3] );
+            }
+        }
+
+        state0 = _mm_add_epi32( state0, abef_save );
+        state1 = _mm_add_epi32( state1, cdgh_save );
+
+        data += 64;
+    }
+
+    tmp    = _mm_shuffle_epi32( state0, 0x1B );          /* FEBA */
+    state1 = _mm_shuffle_epi32( state1, 0xB1 );          /* DCHG */
+    state0 = _mm_blend_epi16( tmp, state1, 0xF0 );       /* DCBA */
+    state1 = _mm_alignr_epi8( state1, tmp, 8 );          /* HGFE */
+
+    _mm_storeu_si128( (__m128i *) &state[0], state0 );
+    _mm_storeu_si128( (__m128i *) &state[4], state1 );
+}
+#endif /* MBEDTLS_SHA256_SHANI */
+
 void mbedtls_sha256_process( mbedtls_sha256_context *ctx, const unsigned char data[64] )
 {
     uint32_t temp1, temp2, W[64];
     uint32_t A[8];
     unsigned int i;
 
+#if defined(MBEDTLS_SHA256_SHANI)
+    if( sha256_shani_support() )
+    {
+        sha256_process_shani( ctx->state, data, 1 );
+        return;
+    }
+#endif /* MBEDTLS_SHA256_SHANI */
+
     for( i = 0; i < 8; i++ )
         A[i] = ctx->state[i];
 
@@ -235,6 +351,27 @@ void mbedtls_sha256_process( mbedtls_sha256_context *ctx, const unsigned char da
 }
 #endif /* !MBEDTLS_SHA256_PROCESS_ALT */
 
+/*
+ * Process a run of consecutive 64-byte blocks
+ */
+static void sha256_process_blocks( mbedtls_sha256_context *ctx,
+                                   const unsigned char *data, size_t blocks )
+{
+#if defined(MBEDTLS_SHA256_SHANI)
+    if( sha256_shani_support() )
+    {
+        sha256_process_shani( ctx->state, data, blocks );
+        return;
+    }
+#endif /* MBEDTLS_SHA256_SHANI */
+
+    while( blocks-- > 0 )
+    {
+        mbedtls_sha256_process( ctx, data );
+        data += 64;
+    }
+}
+
 /*
  * SHA-256 process buffer
  */
@@ -265,11 +402,11 @@ void mbedtls_sha256_update( mbedtls_sha256_context *ctx, const unsigned char *in
         left = 0;
     }
 
-    while( ilen >= 64 )
+    if( ilen >= 64 )
     {
-        mbedtls_sha256_process( ctx, input );
-        input += 64;
-        ilen  -= 64;
+        sha256_process_blocks( ctx, input, ilen / 64 );
+        input += ilen & ~( (size_t) 0x3F );
+        ilen  &= 0x3F;
     }
 
     if( ilen > 0 )
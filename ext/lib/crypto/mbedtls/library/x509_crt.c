@@ -660,7 +660,7 @@ static int x509_get_crt_ext( unsigned char **p,
  * Parse and fill a single X.509 certificate in DER format
  */
 static int x509_crt_parse_der_core( mbedtls_x509_crt *crt, const unsigned char *buf,
-                                    size_t buflen )
+                                    size_t buflen, int make_copy )
 {
     int ret;
     size_t len;
@@ -703,17 +703,30 @@ static int x509_crt_parse_der_core( mbedtls_x509_crt *crt, const unsigned char *
     }
     crt_end = p + len;
 
-    // Create and populate a new buffer for the raw field
     crt->raw.len = crt_end - buf;
-    crt->raw.p = p = mbedtls_calloc( 1, crt->raw.len );
-    if( p == NULL )
-        return( MBEDTLS_ERR_X509_ALLOC_FAILED );
 
-    memcpy( p, buf, crt->raw.len );
+    if( make_copy != 0 )
+    {
+        // Create and populate a new buffer for the raw field
+        crt->raw.p = p = mbedtls_calloc( 1, crt->raw.len );
+        if( p == NULL )
+            return( MBEDTLS_ERR_X509_ALLOC_FAILED );
+
+        memcpy( p, buf, crt->raw.len );
+        crt->own_buffer = 1;
+
+        // Direct pointers to the new buffer
+        p += crt->raw.len - len;
+        end = crt_end = p + len;
+    }
+    else
+    {
+        // Keep pointing into the caller's buffer
+        crt->raw.p = (unsigned char *) buf;
+        crt->own_buffer = 0;
 
-    // Direct pointers to the new buffer 
-    p += crt->raw.len - len;
-    end = crt_end = p + len;
+        end = crt_end;
+    }
 
     /*
      * TBSCertificate  ::=  SEQUENCE  {
@@ -916,8 +929,9 @@ static int x509_crt_parse_der_core( mbedtls_x509_crt *crt, const unsigned char *
  * Parse one X.509 certificate in DER format from a buffer and add them to a
  * chained list
  */
-int mbedtls_x509_crt_parse_der( mbedtls_x509_crt *chain, const unsigned char *buf,
-                        size_t buflen )
+static int x509_crt_parse_der_internal( mbedtls_x509_crt *chain,
+                                        const unsigned char *buf,
+                                        size_t buflen, int make_copy )
 {
     int ret;
     mbedtls_x509_crt *crt = chain, *prev = NULL;
@@ -949,7 +963,7 @@ int mbedtls_x509_crt_parse_der( mbedtls_x509_crt *chain, const unsigned char *bu
         crt = crt->next;
     }
 
-    if( ( ret = x509_crt_parse_der_core( crt, buf, buflen ) ) != 0 )
+    if( ( ret = x509_crt_parse_der_core( crt, buf, buflen, make_copy ) ) != 0 )
     {
         if( prev )
             prev->next = NULL;
@@ -963,6 +977,89 @@ int mbedtls_x509_crt_parse_der( mbedtls_x509_crt *chain, const unsigned char *bu
     return( 0 );
 }
 
+int mbedtls_x509_crt_parse_der( mbedtls_x509_crt *chain, const unsigned char *buf,
+                        size_t buflen )
+{
+    return( x509_crt_parse_der_internal( chain, buf, buflen, 1 ) );
+}
+
+int mbedtls_x509_crt_parse_der_nocopy( mbedtls_x509_crt *chain,
+                                       const unsigned char *buf,
+                                       size_t buflen )
+{
+    return( x509_crt_parse_der_internal( chain, buf, buflen, 0 ) );
+}
+
+/*
+ * Parse one or more certificates from a writable buffer, decoding PEM in
+ * place, and add them to the chained list without copying them
+ */
+int mbedtls_x509_crt_parse_inplace( mbedtls_x509_crt *chain,
+                                    unsigned char *buf, size_t buflen )
+{
+#if defined(MBEDTLS_PEM_PARSE_C)
+    int ret, success = 0, first_error = 0, total_failed = 0;
+    unsigned char *der;
+    size_t der_len, use_len;
+#endif
+
+    /*
+     * Check for valid input
+     */
+    if( chain == NULL || buf == NULL )
+        return( MBEDTLS_ERR_X509_BAD_INPUT_DATA );
+
+#if defined(MBEDTLS_PEM_PARSE_C)
+    while( buflen > 0 )
+    {
+        ret = mbedtls_pem_decode_inplace( "-----BEGIN CERTIFICATE-----",
+                                          "-----END CERTIFICATE-----",
+                                          buf, buflen, &der, &der_len,
+                                          &use_len );
+
+        if( ret == MBEDTLS_ERR_PEM_NO_HEADER_FOOTER_PRESENT )
+            break;
+
+        if( ret == MBEDTLS_ERR_PEM_BAD_INPUT_DATA )
+            return( ret );
+
+        /*
+         * PEM header and footer were found
+         */
+        buflen -= use_len;
+        buf += use_len;
+
+        if( ret == 0 )
+            ret = x509_crt_parse_der_internal( chain, der, der_len, 0 );
+
+        if( ret != 0 )
+        {
+            /*
+             * Quit parsing on a memory error
+             */
+            if( ret == MBEDTLS_ERR_X509_ALLOC_FAILED )
+                return( ret );
+
+            if( first_error == 0 )
+                first_error = ret;
+
+            total_failed++;
+            continue;
+        }
+
+        success = 1;
+    }
+
+    if( success )
+        return( total_failed );
+    else if( first_error )
+        return( first_error );
+#endif /* MBEDTLS_PEM_PARSE_C */
+
+    /* No PEM block, so the buffer holds a single DER certificate */
+    return( x509_crt_parse_der_internal( chain, buf, buflen, 0 ) );
+}
+
 /*
  * Parse one or more PEM certificates from a buffer and add them to the chained
  * list
@@ -2368,7 +2465,7 @@ void mbedtls_x509_crt_free( mbedtls_x509_crt *crt )
             mbedtls_free( seq_prv );
         }
 
-        if( cert_cur->raw.p != NULL )
+        if( cert_cur->raw.p != NULL && cert_cur->own_buffer )
         {
             mbedtls_zeroize( cert_cur->raw.p, cert_cur->raw.len );
             mbedtls_free( cert_cur->raw.p );
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+
+#if !defined(MBEDTLS_CONFIG_FILE)
+#include "mbedtls/config.h"
+#else
+#include MBEDTLS_CONFIG_FILE
+#endif
+
+#if !defined(MBEDTLS_ECP_KEYPAIR_SOURCE)
+#error "CONFIG_MBEDTLS_ECP_POOL requires MBEDTLS_ECP_KEYPAIR_SOURCE"
+#endif
+
+#if !defined(MBEDTLS_THREADING_C) || !defined(MBEDTLS_CTR_DRBG_C)
+#error "CONFIG_MBEDTLS_ECP_POOL requires MBEDTLS_THREADING_C and " \
+	"MBEDTLS_CTR_DRBG_C"
+#endif
+
+#if CONFIG_NUM_PREEMPT_PRIORITIES == 0
+#error "CONFIG_MBEDTLS_ECP_POOL requires a preemptible priority"
+#endif
+
+#include <string.h>
+
+#include "mbedtls/ctr_drbg.h"
+#include "mbedtls/ecp.h"
+#include "zephyr_ecp_pool.h"
+
+/* Back off when the RNG or the heap cannot provide a key pair */
+#define ECP_POOL_RETRY_MSEC	100
+
+struct ecp_pool_entry {
+	mbedtls_mpi d;
+	mbedtls_ecp_point Q;
+};
+
+static const char ecp_pool_pers[] = "zephyr_ecp_pool";
+
+static struct {
+	mbedtls_ecp_group grp;
+
+	/* Seeded from the application's RNG, so that the pool thread does
+	 * not compete for the application's DRBG on every key pair
+	 */
+	mbedtls_ctr_drbg_context drbg;
+
+	/* Ready entries start at head, free_sem counts the empty ones.
+	 * lock protects head and count.
+	 */
+	struct ecp_pool_entry entry[CONFIG_MBEDTLS_ECP_POOL_SIZE];
+	int head;
+	int count;
+	struct k_mutex lock;
+	struct k_sem free_sem;
+
+	/* Set by zephyr_ecp_pool_deinit(), done_sem answers it */
+	bool stop;
+	struct k_sem done_sem;
+} pool;
+
+static char __noinit __stack pool_stack[CONFIG_MBEDTLS_ECP_POOL_STACK_SIZE];
+static k_tid_t pool_tid;
+
+static void ecp_pool_entry_free(struct ecp_pool_entry *e)
+{
+	/* Leaves the entry initialized and empty */
+	mbedtls_mpi_free(&e->d);
+	mbedtls_ecp_point_free(&e->Q);
+}
+
+static int ecp_pool_take(void *p_source, const mbedtls_ecp_group *grp,
+			 mbedtls_mpi *d, mbedtls_ecp_point *Q)
+{
+	struct ecp_pool_entry *e;
+	int ret;
+
+	ARG_UNUSED(p_source);
+
+	/* The pool thread itself has to compute its key pairs */
+	if (k_current_get() == pool_tid || grp->id != pool.grp.id) {
+		return MBEDTLS_ERR_ECP_FEATURE_UNAVAILABLE;
+	}
+
+	k_mutex_lock(&pool.lock, K_FOREVER);
+
+	if (!pool.count) {
+		k_mutex_unlock(&pool.lock);
+		return MBEDTLS_ERR_ECP_FEATURE_UNAVAILABLE;
+	}
+
+	e = &pool.entry[pool.head];
+
+	ret = mbedtls_mpi_copy(d, &e->d);
+	if (!ret) {
+		ret = mbedtls_ecp_copy(Q, &e->Q);
+	}
+
+	if (ret) {
+		k_mutex_unlock(&pool.lock);
+		return ret;
+	}
+
+	/* A key pair is never handed out twice */
+	ecp_pool_entry_free(e);
+	pool.head = (pool.head + 1) % CONFIG_MBEDTLS_ECP_POOL_SIZE;
+	pool.count--;
+
+	k_mutex_unlock(&pool.lock);
+
+	k_sem_give(&pool.free_sem);
+
+	return 0;
+}
+
+static void ecp_pool_fill(void)
+{
+	struct ecp_pool_entry *e;
+	int ret;
+
+	while (1) {
+		k_sem_take(&pool.free_sem, K_FOREVER);
+
+		if (pool.stop) {
+			break;
+		}
+
+		/* The entry after the ready ones, which ecp_pool_take()
+		 * does not look at until count covers it
+		 */
+		k_mutex_lock(&pool.lock, K_FOREVER);
+		e = &pool.entry[(pool.head + pool.count) %
+				CONFIG_MBEDTLS_ECP_POOL_SIZE];
+		k_mutex_unlock(&pool.lock);
+
+		ret = mbedtls_ecp_gen_keypair(&pool.grp, &e->d, &e->Q,
+					      mbedtls_ctr_drbg_random,
+					      &pool.drbg);
+		if (ret) {
+			ecp_pool_entry_free(e);
+			k_sem_give(&pool.free_sem);
+			k_sleep(ECP_POOL_RETRY_MSEC);
+			continue;
+		}
+
+		k_mutex_lock(&pool.lock, K_FOREVER);
+		pool.count++;
+		k_mutex_unlock(&pool.lock);
+	}
+
+	k_sem_give(&pool.done_sem);
+}
+
+int zephyr_ecp_pool_init(mbedtls_ecp_group_id grp_id,
+			 int (*f_rng)(void *, unsigned char *, size_t),
+			 void *p_rng)
+{
+	int i, ret;
+
+	mbedtls_ecp_group_init(&pool.grp);
+	mbedtls_ctr_drbg_init(&pool.drbg);
+
+	for (i = 0; i < CONFIG_MBEDTLS_ECP_POOL_SIZE; i++) {
+		mbedtls_mpi_init(&pool.entry[i].d);
+		mbedtls_ecp_point_init(&pool.entry[i].Q);
+	}
+
+	ret = mbedtls_ecp_group_load(&pool.grp, grp_id);
+	if (ret) {
+		return ret;
+	}
+
+	/* Reseeds draw on f_rng again, from the pool thread */
+	ret = mbedtls_ctr_drbg_seed(&pool.drbg, f_rng, p_rng,
+				    (const unsigned char *)ecp_pool_pers,
+				    strlen(ecp_pool_pers));
+	if (ret) {
+		return ret;
+	}
+
+	pool.head = 0;
+	pool.count = 0;
+	pool.stop = false;
+	k_mutex_init(&pool.lock);
+	k_sem_init(&pool.free_sem, CONFIG_MBEDTLS_ECP_POOL_SIZE,
+		   CONFIG_MBEDTLS_ECP_POOL_SIZE);
+	k_sem_init(&pool.done_sem, 0, 1);
+
+	mbedtls_ecp_set_keypair_source(ecp_pool_take, NULL);
+
+	pool_tid = k_thread_spawn(pool_stack, sizeof(pool_stack),
+				  (k_thread_entry_t)ecp_pool_fill,
+				  NULL, NULL, NULL,
+				  K_LOWEST_APPLICATION_THREAD_PRIO, 0, 0);
+
+	return 0;
+}
+
+void zephyr_ecp_pool_deinit(void)
+{
+	int i;
+
+	mbedtls_ecp_set_keypair_source(NULL, NULL);
+
+	/* The pool thread may be preempted in the middle of a key
+	 * generation, holding mbed TLS mutexes: let it finish and leave
+	 * its loop rather than aborting it there.
+	 */
+	if (pool_tid) {
+		pool.stop = true;
+		k_sem_give(&pool.free_sem);
+		k_sem_take(&pool.done_sem, K_FOREVER);
+
+		/* It holds nothing any more, make sure it is gone before
+		 * its stack can be reused
+		 */
+		k_thread_abort(pool_tid);
+		pool_tid = NULL;
+	}
+
+	for (i = 0; i < CONFIG_MBEDTLS_ECP_POOL_SIZE; i++) {
+		ecp_pool_entry_free(&pool.entry[i]);
+	}
+
+	mbedtls_ecp_group_free(&pool.grp);
+	mbedtls_ctr_drbg_free(&pool.drbg);
+	pool.count = 0;
+}
+
+int zephyr_ecp_pool_count(void)
+{
+	return pool.count;
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* mbed TLS mutexes on top of k_mutex. They are installed before the
+ * application starts, so that the mutexes of the heap, DRBG and entropy
+ * contexts it initializes are valid.
+ */
+
+#include <zephyr.h>
+#include <init.h>
+
+#if !defined(MBEDTLS_CONFIG_FILE)
+#include "mbedtls/config.h"
+#else
+#include MBEDTLS_CONFIG_FILE
+#endif
+
+#if !defined(MBEDTLS_THREADING_C) || !defined(MBEDTLS_THREADING_ALT)
+#error "CONFIG_MBEDTLS_THREADING requires MBEDTLS_THREADING_C and " \
+	"MBEDTLS_THREADING_ALT"
+#endif
+
+#include "mbedtls/threading.h"
+
+static void mutex_init(mbedtls_threading_mutex_t *mutex)
+{
+	if (!mutex || mutex->is_valid) {
+		return;
+	}
+
+	k_mutex_init(&mutex->mutex);
+	mutex->is_valid = 1;
+}
+
+static void mutex_free(mbedtls_threading_mutex_t *mutex)
+{
+	if (!mutex) {
+		return;
+	}
+
+	mutex->is_valid = 0;
+}
+
+static int mutex_lock(mbedtls_threading_mutex_t *mutex)
+{
+	if (!mutex || !mutex->is_valid) {
+		return MBEDTLS_ERR_THREADING_BAD_INPUT_DATA;
+	}
+
+	if (k_mutex_lock(&mutex->mutex, K_FOREVER)) {
+		return MBEDTLS_ERR_THREADING_MUTEX_ERROR;
+	}
+
+	return 0;
+}
+
+static int mutex_unlock(mbedtls_threading_mutex_t *mutex)
+{
+	if (!mutex || !mutex->is_valid) {
+		return MBEDTLS_ERR_THREADING_BAD_INPUT_DATA;
+	}
+
+	k_mutex_unlock(&mutex->mutex);
+
+	return 0;
+}
+
+static int zephyr_mbedtls_threading_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	mbedtls_threading_set_alt(mutex_init, mutex_free, mutex_lock,
+				  mutex_unlock);
+
+	return 0;
+}
+
+SYS_INIT(zephyr_mbedtls_threading_init, POST_KERNEL,
+	 CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
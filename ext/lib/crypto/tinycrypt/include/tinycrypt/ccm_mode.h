@@ -69,6 +69,20 @@
  *            2) call tc_ccm_mode_encrypt to encrypt data and generate tag.
  *
  *            3) call tc_ccm_mode_decrypt to decrypt data and verify tag.
+ *
+ *            Data split over several buffers (e.g. a chain of net_buf
+ *            fragments) can be processed in place, in a single pass:
+ *
+ *            1) call tc_ccm_stream_init with the total associated data and
+ *            payload lengths;
+ *
+ *            2) call tc_ccm_stream_aad for each piece of associated data;
+ *
+ *            3) call tc_ccm_stream_update for each piece of payload, with
+ *            out == in to encrypt or decrypt in place;
+ *
+ *            4) call tc_ccm_stream_tag to get the tag after encryption, or
+ *            tc_ccm_stream_verify to check it after decryption.
  */
 
 #ifndef __TC_CCM_MODE_H__
@@ -94,6 +108,18 @@ typedef struct tc_ccm_mode_struct {
 	uint32_t mlen; /* mac length in bytes (parameter t in SP-800 38C) */
 } *TCCcmMode_t;
 
+/* struct tc_ccm_stream_struct represents a CCM computation in progress */
+typedef struct tc_ccm_stream_struct {
+	TCCcmMode_t c; /* CCM state */
+	uint8_t mac[TC_AES_BLOCK_SIZE]; /* running CBC-MAC */
+	uint8_t ctr[TC_AES_BLOCK_SIZE]; /* counter block */
+	uint8_t keystream[TC_AES_BLOCK_SIZE]; /* encrypted counter block */
+	uint32_t offset; /* bytes used in the current block */
+	uint32_t alen; /* associated data bytes still expected */
+	uint32_t plen; /* payload bytes still expected */
+	uint32_t decrypt; /* MAC the output rather than the input */
+} *TCCcmStream_t;
+
 /**
  * @brief CCM configuration procedure
  * @return returns TC_CRYPTO_SUCCESS (1)
@@ -194,6 +220,85 @@ int32_t tc_ccm_generation_encryption(uint8_t *out, const uint8_t *associated_dat
 int32_t tc_ccm_decryption_verification(uint8_t *out, const uint8_t *associated_data,
 			   uint32_t alen, const uint8_t *payload, uint32_t plen,
 			   TCCcmMode_t c);
+
+/**
+ * @brief Starts a CCM computation over data supplied piecewise
+ * @return returns TC_CRYPTO_SUCCESS (1)
+ *         returns TC_CRYPTO_FAIL (0) if:
+ *                s == NULL or
+ *                c == NULL or
+ *                (alen >= TC_CCM_AAD_MAX_BYTES) or
+ *                (plen >= TC_CCM_PAYLOAD_MAX_BYTES)
+ *
+ * @param s OUT -- CCM stream state
+ * @param c IN -- CCM state, must stay valid until the computation ends
+ * @param alen IN -- total associated data length in bytes
+ * @param plen IN -- total payload length in bytes, without the tag
+ * @param decrypt IN -- 0 to encrypt, 1 to decrypt
+ */
+int32_t tc_ccm_stream_init(TCCcmStream_t s, TCCcmMode_t c, uint32_t alen,
+			   uint32_t plen, uint32_t decrypt);
+
+/**
+ * @brief Authenticates the next piece of associated data
+ * @return returns TC_CRYPTO_SUCCESS (1)
+ *         returns TC_CRYPTO_FAIL (0) if:
+ *                s == NULL or
+ *                ((len > 0) and (data == NULL)) or
+ *                len exceeds the associated data still expected
+ *
+ * @param s IN/OUT -- CCM stream state
+ * @param data IN -- associated data
+ * @param len IN -- length of data in bytes
+ */
+int32_t tc_ccm_stream_aad(TCCcmStream_t s, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief Encrypts or decrypts the next piece of payload
+ * @return returns TC_CRYPTO_SUCCESS (1)
+ *         returns TC_CRYPTO_FAIL (0) if:
+ *                s == NULL or
+ *                ((len > 0) and ((in == NULL) or (out == NULL))) or
+ *                associated data is still expected or
+ *                len exceeds the payload still expected
+ *
+ * @param s IN/OUT -- CCM stream state
+ * @param out OUT -- output, may be equal to in
+ * @param in IN -- input
+ * @param len IN -- length of in and out in bytes
+ */
+int32_t tc_ccm_stream_update(TCCcmStream_t s, uint8_t *out,
+			     const uint8_t *in, uint32_t len);
+
+/**
+ * @brief Produces the tag of an encryption
+ * @return returns TC_CRYPTO_SUCCESS (1)
+ *         returns TC_CRYPTO_FAIL (0) if:
+ *                s == NULL or
+ *                tag == NULL or
+ *                associated data or payload is still expected
+ *
+ * @param tag OUT -- tag, mlen bytes
+ * @param s IN/OUT -- CCM stream state
+ */
+int32_t tc_ccm_stream_tag(uint8_t *tag, TCCcmStream_t s);
+
+/**
+ * @brief Checks the tag of a decryption
+ * @return returns TC_CRYPTO_SUCCESS (1)
+ *         returns TC_CRYPTO_FAIL (0) if:
+ *                s == NULL or
+ *                tag == NULL or
+ *                associated data or payload is still expected or
+ *                the tag does not match
+ *
+ * @note: On failure the caller must discard the decrypted payload.
+ *
+ * @param tag IN -- received tag, mlen bytes
+ * @param s IN/OUT -- CCM stream state
+ */
+int32_t tc_ccm_stream_verify(const uint8_t *tag, TCCcmStream_t s);
+
 #ifdef __cplusplus
 }
 #endif
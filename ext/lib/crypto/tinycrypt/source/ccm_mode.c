@@ -58,146 +58,194 @@ int32_t tc_ccm_config(TCCcmMode_t c, TCAesKeySched_t sched, uint8_t *nonce,
 	return TC_CRYPTO_SUCCESS;
 }
 
-/**
- * Variation of CBC-MAC mode used in CCM.
- */
-static void ccm_cbc_mac(uint8_t *T, const uint8_t *data, uint32_t dlen,
-			 uint32_t flag, TCAesKeySched_t sched)
+int32_t tc_ccm_stream_init(TCCcmStream_t s, TCCcmMode_t c, uint32_t alen,
+			   uint32_t plen, uint32_t decrypt)
 {
-
 	uint32_t i;
 
-	if (flag > 0) {
-		T[0] ^= (uint8_t)(dlen >> 8);
-		T[1] ^= (uint8_t)(dlen);
-		dlen += 2; i = 2;
-	} else {
-		i = 0;
+	/* input sanity check: */
+	if (s == (TCCcmStream_t) 0 ||
+	    c == (TCCcmMode_t) 0 ||
+	    alen >= TC_CCM_AAD_MAX_BYTES || /* associated data size unsupported */
+	    plen >= TC_CCM_PAYLOAD_MAX_BYTES) { /* payload size unsupported */
+		return TC_CRYPTO_FAIL;
 	}
 
-	while (i < dlen) {
-		T[i++ % (Nb * Nk)] ^= *data++;
-		if (((i % (Nb * Nk)) == 0) || dlen == i) {
-			(void) tc_aes_encrypt(T, T, sched);
-		}
+	s->c = c;
+	s->alen = alen;
+	s->plen = plen;
+	s->decrypt = decrypt;
+
+	/* formatting the sequence b for authentication: */
+	s->mac[0] = ((alen > 0) ? 0x40:0) | (((c->mlen - 2) / 2 << 3)) | (1);
+	for (i = 1; i <= 13; ++i) {
+		s->mac[i] = c->nonce[i - 1];
+	}
+	s->mac[14] = (uint8_t)(plen >> 8);
+	s->mac[15] = (uint8_t)(plen);
+	(void) tc_aes_encrypt(s->mac, s->mac, c->sched);
+
+	/* the associated data is prefixed with its length: */
+	s->offset = 0;
+	if (alen > 0) {
+		s->mac[0] ^= (uint8_t)(alen >> 8);
+		s->mac[1] ^= (uint8_t)(alen);
+		s->offset = 2;
+	}
+
+	/* formatting the sequence b for encryption (counter 0): */
+	s->ctr[0] = 1; /* q - 1 = 2 - 1 = 1 */
+	for (i = 1; i <= 13; ++i) {
+		s->ctr[i] = c->nonce[i - 1];
 	}
+	s->ctr[14] = s->ctr[15] = TC_ZERO_BYTE;
+
+	return TC_CRYPTO_SUCCESS;
 }
 
-/**
- * Variation of CTR mode used in CCM.
- * The CTR mode used by CCM is slightly different than the conventional CTR
- * mode (the counter is increased before encryption, instead of after
- * encryption). Besides, it is assumed that the counter is stored in the last
- * 2 bytes of the nonce.
- */
-static int32_t ccm_ctr_mode(uint8_t *out, uint32_t outlen, const uint8_t *in,
-			     uint32_t inlen, uint8_t *ctr, const TCAesKeySched_t sched)
+int32_t tc_ccm_stream_aad(TCCcmStream_t s, const uint8_t *data, uint32_t len)
 {
-
-	uint8_t buffer[TC_AES_BLOCK_SIZE];
-	uint8_t nonce[TC_AES_BLOCK_SIZE];
-	uint16_t block_num;
 	uint32_t i;
 
 	/* input sanity check: */
-	if (out == (uint8_t *) 0 ||
-	    in == (uint8_t *) 0 ||
-	    ctr == (uint8_t *) 0 ||
-	    sched == (TCAesKeySched_t) 0 ||
-	    inlen == 0 ||
-	    outlen == 0 ||
-	    outlen != inlen) {
+	if (s == (TCCcmStream_t) 0 ||
+	    ((len > 0) && (data == (const uint8_t *) 0)) ||
+	    len > s->alen) {
 		return TC_CRYPTO_FAIL;
 	}
 
-	/* copy the counter to the nonce */
-	(void) _copy(nonce, sizeof(nonce), ctr, sizeof(nonce));
-
-	/* select the last 2 bytes of the nonce to be incremented */
-	block_num = (uint16_t) ((nonce[14] << 8)|(nonce[15]));
-	for (i = 0; i < inlen; ++i) {
-		if ((i % (TC_AES_BLOCK_SIZE)) == 0) {
-			block_num++;
-			nonce[14] = (uint8_t)(block_num >> 8);
-			nonce[15] = (uint8_t)(block_num);
-			if (!tc_aes_encrypt(buffer, nonce, sched)) {
-				return TC_CRYPTO_FAIL;
-			}
+	s->alen -= len;
+	for (i = 0; i < len; ++i) {
+		s->mac[s->offset++] ^= data[i];
+		if (s->offset == TC_AES_BLOCK_SIZE) {
+			(void) tc_aes_encrypt(s->mac, s->mac, s->c->sched);
+			s->offset = 0;
 		}
-		/* update the output */
-		*out++ = buffer[i % (TC_AES_BLOCK_SIZE)] ^ *in++;
 	}
 
-	/* update the counter */
-	ctr[14] = nonce[14]; ctr[15] = nonce[15];
+	/* the payload starts on a new block, zero padding is implicit: */
+	if (s->alen == 0 && s->offset > 0) {
+		(void) tc_aes_encrypt(s->mac, s->mac, s->c->sched);
+		s->offset = 0;
+	}
 
 	return TC_CRYPTO_SUCCESS;
 }
 
-int32_t tc_ccm_generation_encryption(uint8_t *out, const uint8_t *associated_data,
-				     uint32_t alen, const uint8_t *payload,
-				     uint32_t plen, TCCcmMode_t c)
+int32_t tc_ccm_stream_update(TCCcmStream_t s, uint8_t *out,
+			     const uint8_t *in, uint32_t len)
 {
+	uint16_t block_num;
+	uint32_t i, n;
+	uint8_t p;
+
 	/* input sanity check: */
-	if ((out == (uint8_t *) 0) ||
-	    (c == (TCCcmMode_t) 0) ||
-	    ((plen > 0) && (payload == (uint8_t *) 0)) ||
-	    ((alen > 0) && (associated_data == (uint8_t *) 0)) ||
-	    (alen >= TC_CCM_AAD_MAX_BYTES) || /* associated data size unsupported */
-	    (plen >= TC_CCM_PAYLOAD_MAX_BYTES)) { /* payload size unsupported */
+	if (s == (TCCcmStream_t) 0 ||
+	    ((len > 0) &&
+	     (in == (const uint8_t *) 0 || out == (uint8_t *) 0)) ||
+	    s->alen > 0 ||
+	    len > s->plen) {
 		return TC_CRYPTO_FAIL;
 	}
 
-	uint8_t b[Nb * Nk];
-	uint8_t tag[Nb * Nk];
-	uint32_t i;
+	s->plen -= len;
+	while (len > 0) {
+		if (s->offset == 0) {
+			/* the counter is increased before encryption */
+			block_num = (uint16_t)((s->ctr[14] << 8) | s->ctr[15]);
+			block_num++;
+			s->ctr[14] = (uint8_t)(block_num >> 8);
+			s->ctr[15] = (uint8_t)(block_num);
+			(void) tc_aes_encrypt(s->keystream, s->ctr, s->c->sched);
+		}
 
-	/* GENERATING THE AUTHENTICATION TAG: */
+		n = TC_AES_BLOCK_SIZE - s->offset;
+		if (n > len) {
+			n = len;
+		}
 
-	/* formatting the sequence b for authentication: */
-	b[0] = ((alen > 0) ? 0x40:0) | (((c->mlen - 2) / 2 << 3)) | (1);
-	for (i = 1; i <= 13; ++i) {
-		b[i] = c->nonce[i - 1];
+		/* single pass: the plaintext byte goes both to the CBC-MAC
+		 * and through the key stream, in is read before out is written
+		 */
+		for (i = 0; i < n; ++i) {
+			p = in[i];
+			out[i] = p ^ s->keystream[s->offset + i];
+			if (s->decrypt) {
+				p = out[i];
+			}
+			s->mac[s->offset + i] ^= p;
+		}
+
+		in += n;
+		out += n;
+		len -= n;
+		s->offset += n;
+
+		if (s->offset == TC_AES_BLOCK_SIZE || s->plen == 0) {
+			(void) tc_aes_encrypt(s->mac, s->mac, s->c->sched);
+			s->offset = 0;
+		}
 	}
-	b[14] = (uint8_t)(plen >> 8);
-	b[15] = (uint8_t)(plen);
 
-	/* computing the authentication tag using cbc-mac: */
-	(void) tc_aes_encrypt(tag, b, c->sched);
-	if (alen > 0) {
-		ccm_cbc_mac(tag, associated_data, alen, 1, c->sched);
+	return TC_CRYPTO_SUCCESS;
+}
+
+/**
+ * Encrypts the CBC-MAC with counter 0, giving the tag.
+ */
+static int32_t ccm_stream_final(uint8_t *tag, TCCcmStream_t s)
+{
+	uint32_t i;
+
+	if (s == (TCCcmStream_t) 0 ||
+	    s->alen > 0 ||
+	    s->plen > 0) {
+		return TC_CRYPTO_FAIL;
 	}
-	if (plen > 0) {
-		ccm_cbc_mac(tag, payload, plen, 0, c->sched);
+
+	s->ctr[14] = s->ctr[15] = TC_ZERO_BYTE;
+	(void) tc_aes_encrypt(s->keystream, s->ctr, s->c->sched);
+	for (i = 0; i < s->c->mlen; ++i) {
+		tag[i] = s->mac[i] ^ s->keystream[i];
 	}
 
-	/* ENCRYPTION: */
+	return TC_CRYPTO_SUCCESS;
+}
+
+int32_t tc_ccm_stream_tag(uint8_t *tag, TCCcmStream_t s)
+{
+	if (tag == (uint8_t *) 0) {
+		return TC_CRYPTO_FAIL;
+	}
 
-	/* formatting the sequence b for encryption: */
-	b[0] = 1; /* q - 1 = 2 - 1 = 1 */
-	b[14] = b[15] = TC_ZERO_BYTE;
+	return ccm_stream_final(tag, s);
+}
 
-	/* encrypting payload using ctr mode: */
-	ccm_ctr_mode(out, plen, payload, plen, b, c->sched);
+int32_t tc_ccm_stream_verify(const uint8_t *tag, TCCcmStream_t s)
+{
+	uint8_t computed[TC_AES_BLOCK_SIZE];
 
-	b[14] = b[15] = TC_ZERO_BYTE; /* restoring initial counter for ctr_mode (0):*/
+	if (tag == (const uint8_t *) 0 ||
+	    ccm_stream_final(computed, s) == TC_CRYPTO_FAIL) {
+		return TC_CRYPTO_FAIL;
+	}
 
-	/* encrypting b and adding the tag to the output: */
-	(void) tc_aes_encrypt(b, b, c->sched);
-	out += plen;
-	for (i = 0; i < c->mlen; ++i) {
-		*out++ = tag[i] ^ b[i];
+	/* comparing the received tag and the computed one: */
+	if (_compare(computed, tag, s->c->mlen) != 0) {
+		return TC_CRYPTO_FAIL;
 	}
 
 	return TC_CRYPTO_SUCCESS;
 }
 
-int32_t tc_ccm_decryption_verification(uint8_t *out, const uint8_t *associated_data,
-				       uint32_t alen, const uint8_t *payload,
-				       uint32_t plen, TCCcmMode_t c)
+int32_t tc_ccm_generation_encryption(uint8_t *out, const uint8_t *associated_data,
+				     uint32_t alen, const uint8_t *payload,
+				     uint32_t plen, TCCcmMode_t c)
 {
+	struct tc_ccm_stream_struct s;
+
 	/* input sanity check: */
-       if ((out == (uint8_t *) 0) ||
+	if ((out == (uint8_t *) 0) ||
 	    (c == (TCCcmMode_t) 0) ||
 	    ((plen > 0) && (payload == (uint8_t *) 0)) ||
 	    ((alen > 0) && (associated_data == (uint8_t *) 0)) ||
@@ -206,53 +254,40 @@ int32_t tc_ccm_decryption_verification(uint8_t *out, const uint8_t *associated_d
 		return TC_CRYPTO_FAIL;
 	}
 
-	uint8_t b[Nb * Nk];
-	uint8_t tag[Nb * Nk];
-	uint32_t i;
-
-	/* DECRYPTION: */
+	(void) tc_ccm_stream_init(&s, c, alen, plen, 0);
+	(void) tc_ccm_stream_aad(&s, associated_data, alen);
+	(void) tc_ccm_stream_update(&s, out, payload, plen);
 
-	/* formatting the sequence b for decryption: */
-	b[0] = 1; /* q - 1 = 2 - 1 = 1 */
-	for (i = 1; i < 14; ++i) {
-		b[i] = c->nonce[i - 1];
-	}
-	b[14] = b[15] = TC_ZERO_BYTE; /* initial counter value is 0 */
-
-	/* decrypting payload using ctr mode: */
-	ccm_ctr_mode(out, plen - c->mlen, payload, plen - c->mlen, b, c->sched);
+	/* adding the tag to the output: */
+	return tc_ccm_stream_tag(out + plen, &s);
+}
 
-	b[14] = b[15] = TC_ZERO_BYTE; /* restoring initial counter value (0) */
+int32_t tc_ccm_decryption_verification(uint8_t *out, const uint8_t *associated_data,
+				       uint32_t alen, const uint8_t *payload,
+				       uint32_t plen, TCCcmMode_t c)
+{
+	struct tc_ccm_stream_struct s;
 
-	/* encrypting b and restoring the tag from input: */
-	(void) tc_aes_encrypt(b, b, c->sched);
-	for (i = 0; i < c->mlen; ++i) {
-		tag[i] = *(payload + plen - c->mlen + i) ^ b[i];
+	/* input sanity check: */
+	if ((out == (uint8_t *) 0) ||
+	    (c == (TCCcmMode_t) 0) ||
+	    ((plen > 0) && (payload == (uint8_t *) 0)) ||
+	    ((alen > 0) && (associated_data == (uint8_t *) 0)) ||
+	    (alen >= TC_CCM_AAD_MAX_BYTES) || /* associated data size unsupported */
+	    (plen >= TC_CCM_PAYLOAD_MAX_BYTES) || /* payload size unsupported */
+	    (plen < c->mlen)) { /* no room for the tag */
+		return TC_CRYPTO_FAIL;
 	}
 
-	/* VERIFYING THE AUTHENTICATION TAG: */
-
-	/* formatting the sequence b for authentication: */
-	b[0] = ((alen > 0) ? 0x40:0)|(((c->mlen - 2) / 2 << 3)) | (1);
-	for (i = 1; i < 14; ++i) {
-		b[i] = c->nonce[i - 1];
-	}
-	b[14] = (uint8_t)((plen - c->mlen) >> 8);
-	b[15] = (uint8_t)(plen - c->mlen);
+	plen -= c->mlen;
 
-	/* computing the authentication tag using cbc-mac: */
-	(void) tc_aes_encrypt(b, b, c->sched);
-	if (alen > 0) {
-		ccm_cbc_mac(b, associated_data, alen, 1, c->sched);
-	}
-	if (plen > 0) {
-		ccm_cbc_mac(b, out, plen - c->mlen, 0, c->sched);
-	}
+	(void) tc_ccm_stream_init(&s, c, alen, plen, 1);
+	(void) tc_ccm_stream_aad(&s, associated_data, alen);
+	(void) tc_ccm_stream_update(&s, out, payload, plen);
 
-	/* comparing the received tag and the computed one: */
-	if (_compare(b, tag, c->mlen) != 0) {
+	if (tc_ccm_stream_verify(payload + plen, &s) == TC_CRYPTO_FAIL) {
 		/* erase the decrypted buffer in case of mac validation failure: */
-		_set(out, 0, sizeof(*out));
+		_set(out, 0, plen);
 		return TC_CRYPTO_FAIL;
 	}
 
@@ -72,13 +72,39 @@ int32_t tc_sha256_update(TCSha256State_t s, const uint8_t *data, size_t datalen)
 		return TC_CRYPTO_SUCCESS;
 	}
 
-	while (datalen-- > 0) {
-		s->leftover[s->leftover_offset++] = *(data++);
-		if (s->leftover_offset >= TC_SHA256_BLOCK_SIZE) {
-			compress(s->iv, s->leftover);
-			s->leftover_offset = 0;
-			s->bits_hashed += (TC_SHA256_BLOCK_SIZE << 3);
+	/* top up a partially filled block first */
+	if (s->leftover_offset > 0) {
+		size_t fill = TC_SHA256_BLOCK_SIZE - s->leftover_offset;
+
+		if (fill > datalen) {
+			fill = datalen;
+		}
+
+		(void)_copy(s->leftover + s->leftover_offset, fill, data, fill);
+		s->leftover_offset += fill;
+		data += fill;
+		datalen -= fill;
+
+		if (s->leftover_offset < TC_SHA256_BLOCK_SIZE) {
+			return TC_CRYPTO_SUCCESS;
 		}
+
+		compress(s->iv, s->leftover);
+		s->leftover_offset = 0;
+		s->bits_hashed += (TC_SHA256_BLOCK_SIZE << 3);
+	}
+
+	/* whole blocks are compressed straight from the caller's buffer */
+	while (datalen >= TC_SHA256_BLOCK_SIZE) {
+		compress(s->iv, data);
+		data += TC_SHA256_BLOCK_SIZE;
+		datalen -= TC_SHA256_BLOCK_SIZE;
+		s->bits_hashed += (TC_SHA256_BLOCK_SIZE << 3);
+	}
+
+	if (datalen > 0) {
+		(void)_copy(s->leftover, TC_SHA256_BLOCK_SIZE, data, datalen);
+		s->leftover_offset = datalen;
 	}
 
 	return TC_CRYPTO_SUCCESS;
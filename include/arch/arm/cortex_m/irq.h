@@ -54,6 +54,11 @@ extern void _irq_priority_set(unsigned int irq, unsigned int prio,
  * argument), and will run even if irq_lock() is active. Be careful!
  */
 #define IRQ_ZERO_LATENCY	(1 << 0)
+
+#define _IRQ_ISR_FLAGS(flags_p) \
+	(((flags_p) & IRQ_ZERO_LATENCY) ? ISR_FLAG_ZERO_LATENCY : 0)
+#else
+#define _IRQ_ISR_FLAGS(flags_p) 0
 #endif
 
 
@@ -80,7 +85,7 @@ extern void _irq_priority_set(unsigned int irq, unsigned int prio,
  */
 #define _ARCH_IRQ_CONNECT(irq_p, priority_p, isr_p, isr_param_p, flags_p) \
 ({ \
-	_ISR_DECLARE(irq_p, 0, isr_p, isr_param_p); \
+	_ISR_DECLARE(irq_p, _IRQ_ISR_FLAGS(flags_p), isr_p, isr_param_p); \
 	_irq_priority_set(irq_p, priority_p, flags_p); \
 	irq_p; \
 })
@@ -94,7 +99,8 @@ extern void _irq_priority_set(unsigned int irq, unsigned int prio,
  */
 #define _ARCH_IRQ_DIRECT_CONNECT(irq_p, priority_p, isr_p, flags_p) \
 ({ \
-	_ISR_DECLARE(irq_p, ISR_FLAG_DIRECT, isr_p, NULL); \
+	_ISR_DECLARE(irq_p, ISR_FLAG_DIRECT | _IRQ_ISR_FLAGS(flags_p), \
+		     isr_p, NULL); \
 	_irq_priority_set(irq_p, priority_p, flags_p); \
 	irq_p; \
 })
@@ -138,6 +144,27 @@ static inline void _arch_isr_direct_footer(int maybe_swap)
 	} \
 	static inline int name##_body(void)
 
+#if CONFIG_ZERO_LATENCY_IRQS
+/**
+ * Place a function with the zero latency ISRs, so that they may call it.
+ * Such a function may not use any kernel service either.
+ */
+#define __zli_text __attribute__((section(".text.zli")))
+
+/**
+ * Declare a zero latency ISR, to be connected with IRQ_DIRECT_CONNECT() and
+ * the IRQ_ZERO_LATENCY flag.
+ *
+ * Zero latency interrupts are not masked by irq_lock(), they may come in
+ * anywhere in the kernel. Hence, unlike with ISR_DIRECT_DECLARE(), no kernel
+ * code runs upon entering or exiting the ISR, and the ISR may not use any
+ * kernel service: the build fails when it calls a function which is not
+ * declared __zli_text.
+ */
+#define ISR_ZERO_LATENCY_DECLARE(name) \
+	__zli_text __attribute__ ((interrupt ("IRQ"))) void name(void)
+#endif
+
 /* Spurious interrupt handler. Throws an error if called */
 extern void _irq_spurious(void *unused);
 
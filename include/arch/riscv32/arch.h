@@ -58,6 +58,10 @@ void _arch_irq_disable(unsigned int irq);
 int _arch_irq_is_enabled(unsigned int irq);
 void _irq_spurious(void *unused);
 
+#if defined(CONFIG_RISCV_NESTED_IRQ)
+/* internal routine documented in C file, needed by IRQ_CONNECT() macro */
+void _irq_priority_set(unsigned int irq, unsigned int prio, uint32_t flags);
+#endif
 
 /**
  * Configure a static interrupt.
@@ -70,13 +74,25 @@ void _irq_spurious(void *unused);
  * @param isr_param_p ISR parameter
  * @param flags_p IRQ options
  *
+ * The priority is only used with CONFIG_RISCV_NESTED_IRQ, to find out which
+ * interrupts may preempt the ISR.
+ *
  * @return The vector assigned to this interrupt
  */
+#if defined(CONFIG_RISCV_NESTED_IRQ)
+#define _ARCH_IRQ_CONNECT(irq_p, priority_p, isr_p, isr_param_p, flags_p) \
+({ \
+	_ISR_DECLARE(irq_p, 0, isr_p, isr_param_p); \
+	_irq_priority_set(irq_p, priority_p, flags_p); \
+	irq_p; \
+})
+#else
 #define _ARCH_IRQ_CONNECT(irq_p, priority_p, isr_p, isr_param_p, flags_p) \
 ({ \
 	_ISR_DECLARE(irq_p, 0, isr_p, isr_param_p); \
 	irq_p; \
 })
+#endif
 
 /*
  * use atomic instruction csrrc to lock global irq
@@ -161,8 +161,9 @@ typedef struct s_isrList {
  * section .text.irqstubs section (which eventually gets linked into 'text')
  * and the stub shall be named (isr_name)_irq(irq_line)_stub
  *
- * 3. The IRQ stub pushes the ISR routine and its argument onto the stack
- * and then jumps to the common interrupt handling code in _interrupt_enter().
+ * 3. The IRQ stub saves EAX and EDX, loads them with the ISR argument and
+ * the ISR routine, and then jumps to the common interrupt handling code in
+ * _interrupt_enter(), which calls the ISR directly.
  *
  * 4. _irq_controller_irq_config() is called at runtime to set the mapping
  * between the vector and the IRQ line as well as triggering flags
@@ -188,8 +189,10 @@ typedef struct s_isrList {
 		".pushsection .text.irqstubs\n\t" \
 		".global %c[isr]_irq%c[irq]_stub\n\t" \
 		"%c[isr]_irq%c[irq]_stub:\n\t" \
-		"pushl %[isr_param]\n\t" \
-		"pushl %[isr]\n\t" \
+		"pushl %%eax\n\t" \
+		"pushl %%edx\n\t" \
+		"movl %[isr_param], %%eax\n\t" \
+		"movl %[isr], %%edx\n\t" \
 		"jmp _interrupt_enter\n\t" \
 		".popsection\n\t" \
 		: \
@@ -126,6 +126,9 @@ static inline int cipher_begin_session(struct device *dev,
 	__ASSERT(flags != (CAP_SYNC_OPS |  CAP_ASYNC_OPS),
 			"conflicting options for sync/async");
 
+	/* Left alone by drivers without batch support */
+	ctx->ops.batch_crypt_hndlr = NULL;
+
 	return api->begin_session(dev, ctx, algo, mode, optype);
 }
 
@@ -268,4 +271,44 @@ static inline int cipher_ccm_op(struct cipher_ctx *ctx,
 	return ctx->ops.ccm_crypt_hndlr(ctx, pkt, nonce);
 }
 
+/*
+ * @brief Perform the crypto operation of a session on several packets
+ *
+ * Hands all requests to the driver in one call, so that it can queue them
+ * to the hardware back to back. The requests are processed in order, with
+ * the mode of the session.
+ *
+ * For an async session the driver either accepts all requests or none of
+ * them, and each packet completes through the registered callback. For a
+ * sync session all packets are processed before returning, stopping at the
+ * first failure.
+ *
+ * @param[in]  ctx       Pointer to the crypto context of this op.
+ * @param[in/out]  reqs  Array of requests, one per packet.
+ * @param[in]  count     Number of requests.
+ *
+ * @return 0 on success, -ENOTSUP if the driver does not support batches,
+ *			  -EBUSY if an async session has no room for all the
+ *			  requests, negative errno code on fail.
+ */
+static inline int cipher_batch_op(struct cipher_ctx *ctx,
+				  struct cipher_batch_req *reqs, int count)
+{
+	int i;
+
+	if (!ctx->ops.batch_crypt_hndlr) {
+		return -ENOTSUP;
+	}
+
+	for (i = 0; i < count; i++) {
+		if (ctx->ops.cipher_mode == CRYPTO_CIPHER_MODE_CCM) {
+			reqs[i].aead_pkt->pkt->ctx = ctx;
+		} else {
+			reqs[i].pkt->ctx = ctx;
+		}
+	}
+
+	return ctx->ops.batch_crypt_hndlr(ctx, reqs, count);
+}
+
 #endif /* __CRYPTO_CIPHER_H__ */
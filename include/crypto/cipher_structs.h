@@ -59,6 +59,19 @@ typedef int (*ctr_op_t)(struct cipher_ctx *ctx, struct cipher_pkt *pkt,
 typedef int (*ccm_op_t)(struct cipher_ctx *ctx, struct cipher_aead_pkt *pkt,
 			 uint8_t *nonce);
 
+/* One request of a batch, see cipher_batch_op(). pkt is used for the block,
+ * CBC and CTR modes, aead_pkt for CCM. iv holds the iv, counter or nonce the
+ * packet is to be processed with, as for the single packet calls.
+ */
+struct cipher_batch_req {
+	struct cipher_pkt *pkt;
+	struct cipher_aead_pkt *aead_pkt;
+	uint8_t *iv;
+};
+
+typedef int (*batch_op_t)(struct cipher_ctx *ctx,
+			  struct cipher_batch_req *reqs, int count);
+
 struct cipher_ops {
 
 	enum cipher_mode cipher_mode;
@@ -69,6 +82,9 @@ struct cipher_ops {
 		ctr_op_t	ctr_crypt_hndlr;
 		ccm_op_t	ccm_crypt_hndlr;
 	};
+
+	/* Optional, for drivers which take several packets per call */
+	batch_op_t batch_crypt_hndlr;
 };
 
 struct ccm_params {
@@ -175,6 +191,9 @@ struct cipher_ctx {
 /* Whether the hardware/driver supports autononce feature */
 #define CAP_AUTONONCE			BIT(7)
 
+/* Whether the driver takes several packets per call, see cipher_batch_op() */
+#define CAP_BATCH_OPS			BIT(8)
+
 
 /* More flags to be added as necessary */
 
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __ENTROPY_POOL_H__
+#define __ENTROPY_POOL_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Entropy pool
+ * @defgroup entropy_pool Entropy pool
+ * @{
+ */
+
+/** Entropy pool counters */
+struct entropy_pool_stats {
+	/** Bytes that passed the health tests and entered the pool */
+	uint32_t harvested;
+	/** Bytes discarded because a health test failed */
+	uint32_t discarded;
+	/** Bytes handed out to consumers */
+	uint32_t served;
+};
+
+/** @brief Get bytes from the entropy pool.
+ *
+ *  The pool is filled in the background from the random driver named
+ *  CONFIG_RANDOM_NAME, or from sys_rand32_get() when there is none, and
+ *  every harvested byte goes through the NIST SP 800-90B repetition
+ *  count and adaptive proportion tests. Requests of any size are served
+ *  from the pool and only wait for the harvester when it runs dry.
+ *
+ *  This is meant as the entropy callback of mbedTLS (registered with
+ *  mbedtls_entropy_add_source()) and as the seed material for TinyCrypt's
+ *  tc_ctr_prng_init() and tc_ctr_prng_reseed().
+ *
+ *  Bytes are never handed out twice and are cleared from the pool once
+ *  read.
+ *
+ *  @param buffer Buffer to fill.
+ *  @param length Number of bytes to get.
+ *  @param timeout Waiting period for the harvester, in milliseconds, or
+ *                 K_NO_WAIT or K_FOREVER.
+ *
+ *  @retval 0 The buffer was filled.
+ *  @retval -EAGAIN The pool did not refill within the timeout.
+ */
+int entropy_pool_get(uint8_t *buffer, size_t length, int32_t timeout);
+
+/** @brief Read the entropy pool counters.
+ *
+ *  @param stats Where to store the counters.
+ */
+void entropy_pool_stats_get(struct entropy_pool_stats *stats);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ENTROPY_POOL_H__ */
@@ -15,6 +15,25 @@
 #include <device.h>
 #include <net/net_if.h>
 
+/**
+ * Work the radio does in hardware, which an L2 can then leave out.
+ */
+enum ieee802154_hw_caps {
+	/** Appends and checks the Frame Check Sequence */
+	IEEE802154_HW_FCS	= BIT(0),
+
+	/** Runs CSMA-CA itself before each transmission */
+	IEEE802154_HW_CSMA	= BIT(1),
+
+	/** Waits for the ACK of a frame requesting one, and retransmits,
+	 * before tx() returns. tx() then fails only when no ACK came.
+	 */
+	IEEE802154_HW_TX_RX_ACK	= BIT(2),
+
+	/** Sends the ACK of a received frame by itself */
+	IEEE802154_HW_AUTO_ACK	= BIT(3),
+};
+
 struct ieee802154_radio_api {
 	/**
 	 * Mandatory to get in first position.
@@ -24,6 +43,9 @@ struct ieee802154_radio_api {
 	 */
 	struct net_if_api iface_api;
 
+	/** Get the hardware capabilities, none when not implemented */
+	enum ieee802154_hw_caps (*get_capabilities)(struct device *dev);
+
 	/** Clear Channel Assesment - Check channel's activity */
 	int (*cca)(struct device *dev);
 
@@ -57,6 +79,32 @@ struct ieee802154_radio_api {
 	uint8_t (*get_lqi)(struct device *dev);
 } __packed;
 
+/**
+ * @brief Get the capabilities of the radio behind an interface
+ *
+ * @details A radio reporting a capability commits to the behaviour
+ *          documented for it in enum ieee802154_hw_caps. An L2 may rely on
+ *          that, e.g. skip its own CSMA-CA backoff for a radio reporting
+ *          IEEE802154_HW_CSMA, or not wait for the ACK of a frame sent on
+ *          one reporting IEEE802154_HW_TX_RX_ACK.
+ *
+ * @param iface A valid pointer on a network interface
+ *
+ * @return A bitmask of enum ieee802154_hw_caps
+ */
+static inline
+enum ieee802154_hw_caps ieee802154_radio_get_hw_capabilities(
+	struct net_if *iface)
+{
+	const struct ieee802154_radio_api *radio = iface->dev->driver_api;
+
+	if (!radio->get_capabilities) {
+		return 0;
+	}
+
+	return radio->get_capabilities(iface->dev);
+}
+
 /**
  * @brief Radio driver sending function that hw drivers should use
  *
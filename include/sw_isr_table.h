@@ -60,6 +60,9 @@ struct _isr_list {
 /** This interrupt gets put directly in the vector table */
 #define ISR_FLAG_DIRECT (1 << 0)
 
+/** Zero latency interrupt, it has to be a direct one too */
+#define ISR_FLAG_ZERO_LATENCY (1 << 1)
+
 #define _MK_ISR_NAME(x, y) __isr_ ## x ## _irq_ ## y
 
 /* Create an instance of struct _isr_list which gets put in the .intList
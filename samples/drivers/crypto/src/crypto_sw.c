@@ -0,0 +1,461 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Software crypto driver on top of TinyCrypt, implementing the whole cipher
+ * API: sync and async sessions, and batches. Requests of an async session
+ * go to a bounded per session queue which the system workqueue drains, so
+ * it behaves like a hardware engine with a request ring and serves as the
+ * reference to compare such drivers against.
+ */
+
+#include <device.h>
+#include <zephyr.h>
+#include <string.h>
+#include <crypto/cipher.h>
+#include <tinycrypt/aes.h>
+#include <tinycrypt/cbc_mode.h>
+#include <tinycrypt/ctr_mode.h>
+#include <tinycrypt/ccm_mode.h>
+#include <tinycrypt/constants.h>
+
+#define SYS_LOG_LEVEL CONFIG_SYS_LOG_CRYPTO_LEVEL
+#include <logging/sys_log.h>
+
+#include "crypto_sw.h"
+
+#define CRYPTO_SW_CAPS	(CAP_RAW_KEY | CAP_SEPARATE_IO_BUFS | \
+			 CAP_SYNC_OPS | CAP_ASYNC_OPS | CAP_BATCH_OPS)
+
+/* TinyCrypt increments the last 32 bits of the counter block */
+#define CRYPTO_SW_CTR_LEN	32
+
+struct crypto_sw_session {
+	struct cipher_ctx *ctx;
+	struct tc_aes_key_sched_struct sched;
+	enum cipher_op op;
+	bool in_use;
+
+	/* Requests of an async session, waiting for the workqueue */
+	struct cipher_batch_req queue[CRYPTO_SW_QUEUE_DEPTH];
+	uint8_t head;
+	uint8_t count;
+	/* Queued requests plus the one being processed */
+	uint8_t pending;
+	struct k_work work;
+};
+
+static struct crypto_sw_session sessions[CRYPTO_SW_MAX_SESSION];
+static crypto_completion_cb completion_cb;
+
+static int do_block(struct crypto_sw_session *s, struct cipher_pkt *pkt)
+{
+	int ret;
+
+	if (pkt->in_len != TC_AES_BLOCK_SIZE ||
+	    pkt->out_buf_max < TC_AES_BLOCK_SIZE) {
+		return -EINVAL;
+	}
+
+	if (s->op == CRYPTO_CIPHER_OP_ENCRYPT) {
+		ret = tc_aes_encrypt(pkt->out_buf, pkt->in_buf, &s->sched);
+	} else {
+		ret = tc_aes_decrypt(pkt->out_buf, pkt->in_buf, &s->sched);
+	}
+
+	if (ret == TC_CRYPTO_FAIL) {
+		return -EIO;
+	}
+
+	pkt->out_len = TC_AES_BLOCK_SIZE;
+
+	return 0;
+}
+
+static int do_cbc(struct crypto_sw_session *s, struct cipher_pkt *pkt,
+		  uint8_t *iv)
+{
+	uint8_t block[TC_AES_BLOCK_SIZE];
+	const uint8_t *prev, *in;
+	uint8_t *out;
+	int i, n;
+
+	if (s->op == CRYPTO_CIPHER_OP_ENCRYPT) {
+		/* The iv goes in front of the cipher text */
+		if (pkt->out_buf_max < pkt->in_len + TC_AES_BLOCK_SIZE) {
+			return -EINVAL;
+		}
+
+		if (tc_cbc_mode_encrypt(pkt->out_buf,
+					pkt->in_len + TC_AES_BLOCK_SIZE,
+					pkt->in_buf, pkt->in_len, iv,
+					&s->sched) == TC_CRYPTO_FAIL) {
+			return -EIO;
+		}
+
+		pkt->out_len = pkt->in_len + TC_AES_BLOCK_SIZE;
+
+		return 0;
+	}
+
+	/* Decryption input is the iv followed by the cipher text, as
+	 * produced above; iv points at it.
+	 */
+	n = pkt->in_len - TC_AES_BLOCK_SIZE;
+	if (n <= 0 || n % TC_AES_BLOCK_SIZE || pkt->out_buf_max < n) {
+		return -EINVAL;
+	}
+
+	prev = iv;
+	in = pkt->in_buf + TC_AES_BLOCK_SIZE;
+	out = pkt->out_buf;
+
+	while (n) {
+		tc_aes_decrypt(block, in, &s->sched);
+		for (i = 0; i < TC_AES_BLOCK_SIZE; i++) {
+			out[i] = block[i] ^ prev[i];
+		}
+
+		prev = in;
+		in += TC_AES_BLOCK_SIZE;
+		out += TC_AES_BLOCK_SIZE;
+		n -= TC_AES_BLOCK_SIZE;
+	}
+
+	pkt->out_len = pkt->in_len - TC_AES_BLOCK_SIZE;
+
+	return 0;
+}
+
+static int do_ctr(struct crypto_sw_session *s, struct cipher_pkt *pkt,
+		  uint8_t *iv)
+{
+	uint8_t ctr[TC_AES_BLOCK_SIZE] = { 0 };
+	int ivlen = TC_AES_BLOCK_SIZE - CRYPTO_SW_CTR_LEN / 8;
+
+	if (pkt->out_buf_max < pkt->in_len) {
+		return -EINVAL;
+	}
+
+	memcpy(ctr, iv, ivlen);
+
+	if (tc_ctr_mode(pkt->out_buf, pkt->in_len, pkt->in_buf, pkt->in_len,
+			ctr, &s->sched) == TC_CRYPTO_FAIL) {
+		return -EIO;
+	}
+
+	pkt->out_len = pkt->in_len;
+
+	return 0;
+}
+
+static int do_ccm(struct crypto_sw_session *s, struct cipher_aead_pkt *aead,
+		  uint8_t *nonce)
+{
+	struct ccm_params *params = &s->ctx->mode_params.ccm_info;
+	struct cipher_pkt *pkt = aead->pkt;
+	struct tc_ccm_mode_struct ccm;
+
+	if (tc_ccm_config(&ccm, &s->sched, nonce, params->nonce_len,
+			  params->tag_len) == TC_CRYPTO_FAIL) {
+		return -EINVAL;
+	}
+
+	if (s->op == CRYPTO_CIPHER_OP_ENCRYPT) {
+		/* The tag is appended to the cipher text */
+		if (pkt->out_buf_max < pkt->in_len + params->tag_len) {
+			return -EINVAL;
+		}
+
+		if (tc_ccm_generation_encryption(pkt->out_buf, aead->ad,
+						 aead->ad_len, pkt->in_buf,
+						 pkt->in_len, &ccm) ==
+		    TC_CRYPTO_FAIL) {
+			return -EIO;
+		}
+
+		pkt->out_len = pkt->in_len + params->tag_len;
+		aead->tag = pkt->out_buf + pkt->in_len;
+
+		return 0;
+	}
+
+	/* TinyCrypt expects the tag right after the cipher text */
+	if (aead->tag != pkt->in_buf + pkt->in_len ||
+	    pkt->out_buf_max < pkt->in_len) {
+		return -EINVAL;
+	}
+
+	if (tc_ccm_decryption_verification(pkt->out_buf, aead->ad,
+					   aead->ad_len, pkt->in_buf,
+					   pkt->in_len + params->tag_len,
+					   &ccm) == TC_CRYPTO_FAIL) {
+		return -EFAULT;
+	}
+
+	pkt->out_len = pkt->in_len;
+
+	return 0;
+}
+
+static int crypto_sw_process(struct crypto_sw_session *s,
+			     struct cipher_batch_req *req)
+{
+	switch (s->ctx->ops.cipher_mode) {
+	case CRYPTO_CIPHER_MODE_ECB:
+		return do_block(s, req->pkt);
+	case CRYPTO_CIPHER_MODE_CBC:
+		return do_cbc(s, req->pkt, req->iv);
+	case CRYPTO_CIPHER_MODE_CTR:
+		return do_ctr(s, req->pkt, req->iv);
+	case CRYPTO_CIPHER_MODE_CCM:
+		return do_ccm(s, req->aead_pkt, req->iv);
+	default:
+		return -ENOTSUP;
+	}
+}
+
+static void crypto_sw_work(struct k_work *work)
+{
+	struct crypto_sw_session *s =
+		CONTAINER_OF(work, struct crypto_sw_session, work);
+	struct cipher_batch_req req;
+	struct cipher_pkt *pkt;
+	unsigned int key;
+	int status;
+
+	while (1) {
+		key = irq_lock();
+
+		if (!s->count) {
+			irq_unlock(key);
+			break;
+		}
+
+		req = s->queue[s->head];
+		s->head = (s->head + 1) % CRYPTO_SW_QUEUE_DEPTH;
+		s->count--;
+
+		irq_unlock(key);
+
+		status = crypto_sw_process(s, &req);
+
+		if (s->ctx->ops.cipher_mode == CRYPTO_CIPHER_MODE_CCM) {
+			pkt = req.aead_pkt->pkt;
+		} else {
+			pkt = req.pkt;
+		}
+
+		/* The key schedule is no longer needed, the callback may
+		 * free the session.
+		 */
+		key = irq_lock();
+		s->pending--;
+		irq_unlock(key);
+
+		completion_cb(pkt, status);
+	}
+}
+
+static int crypto_sw_batch(struct cipher_ctx *ctx,
+			   struct cipher_batch_req *reqs, int count)
+{
+	struct crypto_sw_session *s = ctx->drv_sessn_state;
+	unsigned int key;
+	int i, ret;
+
+	if (ctx->flags & CAP_SYNC_OPS) {
+		for (i = 0; i < count; i++) {
+			ret = crypto_sw_process(s, &reqs[i]);
+			if (ret) {
+				return ret;
+			}
+		}
+
+		return 0;
+	}
+
+	if (!completion_cb) {
+		SYS_LOG_ERR("No completion callback for async session");
+		return -EINVAL;
+	}
+
+	key = irq_lock();
+
+	if (s->count + count > CRYPTO_SW_QUEUE_DEPTH) {
+		irq_unlock(key);
+		return -EBUSY;
+	}
+
+	for (i = 0; i < count; i++) {
+		s->queue[(s->head + s->count) % CRYPTO_SW_QUEUE_DEPTH] =
+			reqs[i];
+		s->count++;
+		s->pending++;
+	}
+
+	irq_unlock(key);
+
+	k_work_submit(&s->work);
+
+	return 0;
+}
+
+static int crypto_sw_block_op(struct cipher_ctx *ctx, struct cipher_pkt *pkt)
+{
+	struct cipher_batch_req req = { .pkt = pkt };
+
+	return crypto_sw_batch(ctx, &req, 1);
+}
+
+static int crypto_sw_iv_op(struct cipher_ctx *ctx, struct cipher_pkt *pkt,
+			   uint8_t *iv)
+{
+	struct cipher_batch_req req = { .pkt = pkt, .iv = iv };
+
+	return crypto_sw_batch(ctx, &req, 1);
+}
+
+static int crypto_sw_ccm_op(struct cipher_ctx *ctx,
+			    struct cipher_aead_pkt *aead, uint8_t *nonce)
+{
+	struct cipher_batch_req req = { .aead_pkt = aead, .iv = nonce };
+
+	return crypto_sw_batch(ctx, &req, 1);
+}
+
+static int crypto_sw_query_caps(struct device *dev)
+{
+	return CRYPTO_SW_CAPS;
+}
+
+static int crypto_sw_begin_session(struct device *dev, struct cipher_ctx *ctx,
+				   enum cipher_algo algo,
+				   enum cipher_mode mode,
+				   enum cipher_op op_type)
+{
+	struct crypto_sw_session *s = NULL;
+	unsigned int key;
+	int i;
+
+	if (algo != CRYPTO_CIPHER_ALGO_AES || ctx->keylen != TC_AES_KEY_SIZE) {
+		SYS_LOG_ERR("Only AES-128 is supported");
+		return -EINVAL;
+	}
+
+	if (ctx->flags & ~CRYPTO_SW_CAPS) {
+		SYS_LOG_ERR("Unsupported flags 0x%x",
+			    ctx->flags & ~CRYPTO_SW_CAPS);
+		return -EINVAL;
+	}
+
+	if (mode == CRYPTO_CIPHER_MODE_CTR &&
+	    ctx->mode_params.ctr_info.ctr_len != CRYPTO_SW_CTR_LEN) {
+		SYS_LOG_ERR("Only a %d bit counter is supported",
+			    CRYPTO_SW_CTR_LEN);
+		return -EINVAL;
+	}
+
+	key = irq_lock();
+
+	for (i = 0; i < CRYPTO_SW_MAX_SESSION; i++) {
+		if (!sessions[i].in_use) {
+			s = &sessions[i];
+			s->in_use = true;
+			break;
+		}
+	}
+
+	irq_unlock(key);
+
+	if (!s) {
+		SYS_LOG_ERR("All %d sessions in use", CRYPTO_SW_MAX_SESSION);
+		return -ENOSPC;
+	}
+
+	switch (mode) {
+	case CRYPTO_CIPHER_MODE_ECB:
+		ctx->ops.block_crypt_hndlr = crypto_sw_block_op;
+		break;
+	case CRYPTO_CIPHER_MODE_CBC:
+		ctx->ops.cbc_crypt_hndlr = crypto_sw_iv_op;
+		break;
+	case CRYPTO_CIPHER_MODE_CTR:
+		ctx->ops.ctr_crypt_hndlr = crypto_sw_iv_op;
+		break;
+	case CRYPTO_CIPHER_MODE_CCM:
+		ctx->ops.ccm_crypt_hndlr = crypto_sw_ccm_op;
+		break;
+	default:
+		s->in_use = false;
+		return -ENOTSUP;
+	}
+
+	ctx->ops.batch_crypt_hndlr = crypto_sw_batch;
+
+	/* CTR and CCM only ever run the cipher forward */
+	if (op_type == CRYPTO_CIPHER_OP_DECRYPT &&
+	    (mode == CRYPTO_CIPHER_MODE_ECB || mode == CRYPTO_CIPHER_MODE_CBC)) {
+		tc_aes128_set_decrypt_key(&s->sched, ctx->key.bit_stream);
+	} else {
+		tc_aes128_set_encrypt_key(&s->sched, ctx->key.bit_stream);
+	}
+
+	s->ctx = ctx;
+	s->op = op_type;
+	s->head = 0;
+	s->count = 0;
+	s->pending = 0;
+	k_work_init(&s->work, crypto_sw_work);
+
+	ctx->drv_sessn_state = s;
+
+	return 0;
+}
+
+static int crypto_sw_free_session(struct device *dev, struct cipher_ctx *ctx)
+{
+	struct crypto_sw_session *s = ctx->drv_sessn_state;
+	unsigned int key;
+
+	key = irq_lock();
+
+	/* The workqueue may still be using the key schedule */
+	if (s->pending) {
+		irq_unlock(key);
+		return -EBUSY;
+	}
+
+	memset(&s->sched, 0, sizeof(s->sched));
+	ctx->drv_sessn_state = NULL;
+	s->in_use = false;
+
+	irq_unlock(key);
+
+	return 0;
+}
+
+static int crypto_sw_callback_set(struct device *dev, crypto_completion_cb cb)
+{
+	completion_cb = cb;
+
+	return 0;
+}
+
+static int crypto_sw_init(struct device *dev)
+{
+	return 0;
+}
+
+static const struct crypto_driver_api crypto_sw_api = {
+	.query_hw_caps = crypto_sw_query_caps,
+	.begin_session = crypto_sw_begin_session,
+	.free_session = crypto_sw_free_session,
+	.crypto_async_callback_set = crypto_sw_callback_set,
+};
+
+DEVICE_AND_API_INIT(crypto_sw, CRYPTO_SW_DRV_NAME, crypto_sw_init, NULL, NULL,
+		    POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEVICE,
+		    (void *)&crypto_sw_api);
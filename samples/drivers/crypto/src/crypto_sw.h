@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) 2017 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __CRYPTO_SW_H__
+#define __CRYPTO_SW_H__
+
+#define CRYPTO_SW_DRV_NAME	"CRYPTO_SW"
+
+/* Sessions which can be open at the same time */
+#define CRYPTO_SW_MAX_SESSION	4
+
+/* Requests an async session can have outstanding */
+#define CRYPTO_SW_QUEUE_DEPTH	8
+
+#endif /* __CRYPTO_SW_H__ */
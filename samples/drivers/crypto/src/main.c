@@ -16,6 +16,8 @@
 #define SYS_LOG_LEVEL CONFIG_SYS_LOG_CRYPTO_LEVEL
 #include <logging/sys_log.h>
 
+#include "crypto_sw.h"
+
 uint8_t key[16] = {
 	0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6, 0xab, 0xf7, 0x15, 0x88,
 	0x09, 0xcf, 0x4f, 0x3c
@@ -318,10 +320,142 @@ void ccm_mode(void)
 	cipher_free_session(dev, &ini);
 }
 
+#define BATCH_PKTS	CRYPTO_SW_QUEUE_DEPTH
+#define BATCH_ROUNDS	64
+
+static uint8_t batch_out[BATCH_PKTS][sizeof(plaintext)];
+static K_SEM_DEFINE(batch_done, 0, BATCH_PKTS);
+static int batch_errors;
+
+static void batch_cb(struct cipher_pkt *completed, int status)
+{
+	if (status) {
+		batch_errors++;
+	}
+
+	k_sem_give(&batch_done);
+}
+
+static uint32_t ctr_run(struct device *dev, uint16_t flags, bool batch)
+{
+	struct cipher_ctx ini;
+	struct cipher_pkt pkts[BATCH_PKTS];
+	struct cipher_batch_req reqs[BATCH_PKTS];
+	uint8_t ivs[BATCH_PKTS][12];
+	uint32_t start;
+	int i, j, ret = 0;
+
+	ini.keylen = 16;
+	ini.key.bit_stream = key;
+	ini.flags = flags;
+	ini.mode_params.ctr_info.ctr_len = 32;
+
+	if (cipher_begin_session(dev, &ini, CRYPTO_CIPHER_ALGO_AES,
+				 CRYPTO_CIPHER_MODE_CTR,
+				 CRYPTO_CIPHER_OP_ENCRYPT)) {
+		return 0;
+	}
+
+	for (i = 0; i < BATCH_PKTS; i++) {
+		memset(ivs[i], 0, sizeof(ivs[i]));
+		ivs[i][0] = i;
+
+		pkts[i].in_buf = plaintext;
+		pkts[i].in_len = sizeof(plaintext);
+		pkts[i].out_buf = batch_out[i];
+		pkts[i].out_buf_max = sizeof(batch_out[i]);
+
+		reqs[i].pkt = &pkts[i];
+		reqs[i].aead_pkt = NULL;
+		reqs[i].iv = ivs[i];
+	}
+
+	start = k_cycle_get_32();
+
+	for (j = 0; j < BATCH_ROUNDS && !ret; j++) {
+		if (batch) {
+			ret = cipher_batch_op(&ini, reqs, BATCH_PKTS);
+		} else {
+			for (i = 0; i < BATCH_PKTS && !ret; i++) {
+				ret = cipher_ctr_op(&ini, &pkts[i], ivs[i]);
+			}
+		}
+
+		if (flags & CAP_ASYNC_OPS) {
+			for (i = 0; i < BATCH_PKTS && !ret; i++) {
+				k_sem_take(&batch_done, K_FOREVER);
+			}
+		}
+	}
+
+	start = k_cycle_get_32() - start;
+
+	cipher_free_session(dev, &ini);
+
+	if (ret || batch_errors) {
+		SYS_LOG_ERR("CTR run failed: %d, %d errors", ret,
+			    batch_errors);
+		return 0;
+	}
+
+	return start;
+}
+
+void batch_mode(void)
+{
+	struct device *dev;
+	uint8_t expected[BATCH_PKTS][sizeof(plaintext)];
+	uint32_t sync_cycles, batch_cycles;
+
+	SYS_LOG_INF("Batch Mode\n");
+
+	dev = device_get_binding(CRYPTO_SW_DRV_NAME);
+	if (!dev) {
+		SYS_LOG_ERR("Software crypto device not found\n");
+		return;
+	}
+
+	if ((cipher_query_hwcaps(dev) & (CAP_ASYNC_OPS | CAP_BATCH_OPS)) !=
+	    (CAP_ASYNC_OPS | CAP_BATCH_OPS)) {
+		SYS_LOG_ERR("Async batches not supported\n");
+		return;
+	}
+
+	cipher_callback_set(dev, batch_cb);
+
+	sync_cycles = ctr_run(dev, CAP_RAW_KEY | CAP_SYNC_OPS |
+			      CAP_SEPARATE_IO_BUFS, false);
+	memcpy(expected, batch_out, sizeof(expected));
+	memset(batch_out, 0, sizeof(batch_out));
+
+	batch_cycles = ctr_run(dev, CAP_RAW_KEY | CAP_ASYNC_OPS |
+			       CAP_SEPARATE_IO_BUFS | CAP_BATCH_OPS, true);
+
+	if (!sync_cycles || !batch_cycles) {
+		return;
+	}
+
+	if (memcmp(batch_out, expected, sizeof(expected))) {
+		SYS_LOG_ERR("batch mode - Mismatch between sync and async "
+			    "cipher text\n");
+		return;
+	}
+	SYS_LOG_INF("batch mode - Match\n");
+
+	SYS_LOG_INF("%d x %d packets of %d bytes: sync %u us, "
+		    "async batches %u us\n", BATCH_ROUNDS, BATCH_PKTS,
+		    (int)sizeof(plaintext),
+		    (uint32_t)(SYS_CLOCK_HW_CYCLES_TO_NS64(sync_cycles) /
+			       NSEC_PER_USEC),
+		    (uint32_t)(SYS_CLOCK_HW_CYCLES_TO_NS64(batch_cycles) /
+			       NSEC_PER_USEC));
+}
+
 void main(void)
 {
 	SYS_LOG_INF("Cipher Sample\n");
 	cbc_mode();
 	ctr_mode();
 	ccm_mode();
+	batch_mode();
 }
@@ -29,6 +29,9 @@ char __noinit __stack thread_stack[STACKSIZE];
 
 static struct net_mgmt_event_callback mgmt_cb;
 
+/* When negotiation started, to report the time to network */
+static uint32_t start_time;
+
 static void handler(struct net_mgmt_event_callback *cb,
 		    uint32_t mgmt_event,
 		    struct net_if *iface)
@@ -57,6 +60,8 @@ static void handler(struct net_mgmt_event_callback *cb,
 		NET_INFO("Router: %s",
 			 net_addr_ntop(AF_INET, &iface->ipv4.gw,
 				       buf, sizeof(buf)));
+		NET_INFO("Time to address: %u ms",
+			 k_uptime_get_32() - start_time);
 	}
 }
 
@@ -72,6 +77,7 @@ static void main_thread(void)
 
 	iface = net_if_get_default();
 
+	start_time = k_uptime_get_32();
 	net_dhcpv4_start(iface);
 }
 
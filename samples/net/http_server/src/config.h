@@ -27,6 +27,7 @@
 
 #ifdef CONFIG_MBEDTLS
 #define SERVER_PORT		443
+#define SSL_MAX_CONNECTIONS	2
 #endif
 
 #endif
@@ -31,6 +31,9 @@
 #include <string.h>
 #include <net/net_context.h>
 #include <net/net_if.h>
+#if defined(CONFIG_ENTROPY_POOL)
+#include <entropy_pool.h>
+#endif
 #include "config.h"
 #include "ssl_utils.h"
 #include "test_certs.h"
@@ -44,6 +47,15 @@
 #include "mbedtls/error.h"
 #include "mbedtls/debug.h"
 
+#if defined(MBEDTLS_SSL_CACHE_C)
+#include "mbedtls/ssl_cache.h"
+/*
+ * Sessions of returning clients are resumed from the cache, which skips
+ * the certificate exchange and the RSA private key operation.
+ */
+#define SSL_CACHE_MAX_ENTRIES	4
+#endif
+
 #if defined(MBEDTLS_DEBUG_C)
 #include "mbedtls/debug.h"
 #define DEBUG_THRESHOLD 0
@@ -51,7 +63,8 @@
 
 #if defined(MBEDTLS_MEMORY_BUFFER_ALLOC_C)
 #include "mbedtls/memory_buffer_alloc.h"
-static unsigned char heap[12000];
+/* Each connection needs its own record buffers on top of the shared state */
+static unsigned char heap[8000 + SSL_MAX_CONNECTIONS * 4000];
 #endif
 
 /*
@@ -102,6 +115,16 @@ static void my_debug(void *ctx, int level,
 static int entropy_source(void *data, unsigned char *output, size_t len,
 			  size_t *olen)
 {
+#if defined(CONFIG_ENTROPY_POOL)
+	ARG_UNUSED(data);
+
+	if (entropy_pool_get(output, len, K_FOREVER)) {
+		return MBEDTLS_ERR_ENTROPY_SOURCE_FAILED;
+	}
+
+	*olen = len;
+	return 0;
+#else
 	uint32_t seed;
 
 	ARG_UNUSED(data);
@@ -116,6 +139,7 @@ static int entropy_source(void *data, unsigned char *output, size_t len,
 
 	*olen = len;
 	return 0;
+#endif
 }
 
 static
@@ -131,18 +155,175 @@ int on_url(struct http_parser *parser, const char *at, size_t length)
 
 static unsigned char payload[256];
 
+/*
+ * All connections are served from the https_server thread. A connection
+ * only advances when its receive FIFO has data, and gives the thread back
+ * as soon as mbedTLS asks for more input, so a slow client does not stall
+ * the handshakes of the others.
+ */
+enum tls_conn_state {
+	TLS_CONN_IDLE,
+	TLS_CONN_HANDSHAKE,
+	TLS_CONN_READ,
+	TLS_CONN_WRITE,
+};
+
+struct tls_conn {
+	mbedtls_ssl_context ssl;
+	struct parsed_url request;
+	enum tls_conn_state state;
+	const char *response;
+	uint32_t start;
+};
+
+static struct ssl_context ctx[SSL_MAX_CONNECTIONS];
+static struct tls_conn conns[SSL_MAX_CONNECTIONS];
+static int active_conns;
+
+static void tls_conn_start(int id)
+{
+	struct tls_conn *conn = &conns[id];
+
+	mbedtls_ssl_session_reset(&conn->ssl);
+	mbedtls_ssl_set_bio(&conn->ssl, &ctx[id], ssl_tx, ssl_rx, NULL);
+
+	http_parser_init(&ctx[id].parser, HTTP_REQUEST);
+	conn->request.url = NULL;
+	conn->request.url_len = 0;
+
+	conn->start = k_cycle_get_32();
+	conn->state = TLS_CONN_HANDSHAKE;
+	active_conns++;
+}
+
+static void tls_conn_close(int id)
+{
+	struct tls_conn *conn = &conns[id];
+
+	ssl_close(&ctx[id]);
+	conn->state = TLS_CONN_IDLE;
+	active_conns--;
+}
+
+static int tls_conn_read(int id)
+{
+	struct tls_conn *conn = &conns[id];
+	struct parsed_url *request = &conn->request;
+	int ret, len;
+
+	len = sizeof(payload) - 1;
+	memset(payload, 0, sizeof(payload));
+	ret = mbedtls_ssl_read(&conn->ssl, payload, len);
+	if (ret == 0) {
+		return MBEDTLS_ERR_SSL_CONN_EOF;
+	} else if (ret < 0) {
+		return ret;
+	}
+
+	len = ret;
+	http_parser_execute(&ctx[id].parser, &ctx[id].parser_settings,
+			    payload, len);
+
+	/* The URL points into payload, which the next connection reuses */
+	if (request->url &&
+	    !strncmp("/index.html", request->url, request->url_len)) {
+		conn->response = HTTP_RESPONSE;
+	} else {
+		conn->response = HTTP_NOT_FOUND;
+	}
+
+	conn->state = TLS_CONN_WRITE;
+	return 0;
+}
+
+static void tls_conn_process(int id)
+{
+	struct tls_conn *conn = &conns[id];
+	uint32_t elapsed_ms;
+	int ret;
+
+	if (conn->state == TLS_CONN_IDLE) {
+		tls_conn_start(id);
+	}
+
+	while (1) {
+		switch (conn->state) {
+		case TLS_CONN_HANDSHAKE:
+			ret = mbedtls_ssl_handshake(&conn->ssl);
+			if (ret == 0) {
+				elapsed_ms = SYS_CLOCK_HW_CYCLES_TO_NS64(
+					k_cycle_get_32() - conn->start) /
+					(NSEC_PER_USEC * USEC_PER_MSEC);
+				mbedtls_printf("Connection %d: handshake done in"
+					       " %u ms (%d active)\n", id,
+					       elapsed_ms, active_conns);
+				conn->state = TLS_CONN_READ;
+			}
+			break;
+
+		case TLS_CONN_READ:
+			ret = tls_conn_read(id);
+			break;
+
+		case TLS_CONN_WRITE:
+			ret = mbedtls_ssl_write(&conn->ssl,
+						(const unsigned char *)conn->response,
+						strlen(conn->response));
+			if (ret > 0) {
+				mbedtls_ssl_close_notify(&conn->ssl);
+				tls_conn_close(id);
+				return;
+			}
+			break;
+
+		default:
+			return;
+		}
+
+		if (ret == MBEDTLS_ERR_SSL_WANT_READ ||
+		    ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
+			return;
+		}
+
+		if (ret < 0) {
+			switch (ret) {
+			case MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY:
+				mbedtls_printf("Connection %d: closed"
+					       " gracefully\n", id);
+				break;
+
+			case MBEDTLS_ERR_SSL_CONN_EOF:
+			case MBEDTLS_ERR_NET_CONN_RESET:
+				mbedtls_printf("Connection %d: reset by"
+					       " peer\n", id);
+				break;
+
+			default:
+				mbedtls_printf("Connection %d: failed, state %d"
+					       " returned -0x%x\n", id,
+					       conn->state, -ret);
+				break;
+			}
+
+			tls_conn_close(id);
+			return;
+		}
+	}
+}
+
 void https_server(void)
 {
-	struct ssl_context ctx;
-	struct parsed_url request;
-	int ret, len = 0;
+	struct k_poll_event events[SSL_MAX_CONNECTIONS];
+	int i, ret;
 
 	mbedtls_entropy_context entropy;
 	mbedtls_ctr_drbg_context ctr_drbg;
-	mbedtls_ssl_context ssl;
 	mbedtls_ssl_config conf;
 	mbedtls_x509_crt srvcert;
 	mbedtls_pk_context pkey;
+#if defined(MBEDTLS_SSL_CACHE_C)
+	mbedtls_ssl_cache_context cache;
+#endif
 
 	mbedtls_platform_set_printf(printk);
 
@@ -156,10 +337,16 @@ void https_server(void)
 #endif
 	mbedtls_x509_crt_init(&srvcert);
 	mbedtls_pk_init(&pkey);
-	mbedtls_ssl_init(&ssl);
+	for (i = 0; i < SSL_MAX_CONNECTIONS; i++) {
+		mbedtls_ssl_init(&conns[i].ssl);
+	}
 	mbedtls_ssl_config_init(&conf);
 	mbedtls_entropy_init(&entropy);
 	mbedtls_ctr_drbg_init(&ctr_drbg);
+#if defined(MBEDTLS_SSL_CACHE_C)
+	mbedtls_ssl_cache_init(&cache);
+	mbedtls_ssl_cache_set_max_entries(&cache, SSL_CACHE_MAX_ENTRIES);
+#endif
 
 	/*
 	 * 1. Load the certificates and private RSA key
@@ -214,6 +401,12 @@ void https_server(void)
 	mbedtls_ssl_conf_rng(&conf, mbedtls_ctr_drbg_random, &ctr_drbg);
 	mbedtls_ssl_conf_dbg(&conf, my_debug, NULL);
 
+#if defined(MBEDTLS_SSL_CACHE_C)
+	mbedtls_ssl_conf_session_cache(&conf, &cache,
+				       mbedtls_ssl_cache_get,
+				       mbedtls_ssl_cache_set);
+#endif
+
 	mbedtls_ssl_conf_ca_chain(&conf, srvcert.next, NULL);
 	ret = mbedtls_ssl_conf_own_cert(&conf, &srvcert, &pkey);
 	if (ret != 0) {
@@ -223,17 +416,26 @@ void https_server(void)
 		goto exit;
 	}
 
-	ret = mbedtls_ssl_setup(&ssl, &conf);
-	if (ret != 0) {
-		mbedtls_printf(" failed\n  !"
-			       " mbedtls_ssl_setup returned %d\n\n", ret);
-		goto exit;
+	/*
+	 * The configuration, RNG and session cache are shared, each
+	 * connection only owns its mbedtls_ssl_context.
+	 */
+	for (i = 0; i < SSL_MAX_CONNECTIONS; i++) {
+		ret = mbedtls_ssl_setup(&conns[i].ssl, &conf);
+		if (ret != 0) {
+			mbedtls_printf(" failed\n  !"
+				       " mbedtls_ssl_setup returned %d\n\n",
+				       ret);
+			goto exit;
+		}
+
+		conns[i].state = TLS_CONN_IDLE;
 	}
 
 	/*
-	 * 3. Wait until a client connects
+	 * 3. Start accepting clients
 	 */
-	ret = ssl_init(&ctx, &server_addr);
+	ret = ssl_init(ctx, SSL_MAX_CONNECTIONS, &server_addr);
 	if (ret != 0) {
 		mbedtls_printf(" failed\n  ! ssl_init returned %d\n\n", ret);
 		goto exit;
@@ -241,126 +443,52 @@ void https_server(void)
 	}
 
 	/*
-	 * 4. Prepare http parser
+	 * 4. Prepare http parsers and the events to wait on
 	 */
-	http_parser_init(&ctx.parser, HTTP_REQUEST);
-	http_parser_settings_init(&ctx.parser_settings);
-	ctx.parser.data = &request;
-	ctx.parser_settings.on_url = on_url;
+	for (i = 0; i < SSL_MAX_CONNECTIONS; i++) {
+		http_parser_settings_init(&ctx[i].parser_settings);
+		ctx[i].parser.data = &conns[i].request;
+		ctx[i].parser_settings.on_url = on_url;
+
+		k_poll_event_init(&events[i], K_POLL_TYPE_FIFO_DATA_AVAILABLE,
+				  K_POLL_MODE_NOTIFY_ONLY, &ctx[i].rx_fifo);
+	}
 
 	mbedtls_printf("Zephyr HTTPS Server\n");
 	mbedtls_printf("Address: %s, port: %d\n", ZEPHYR_ADDR, SERVER_PORT);
-reset:
-	mbedtls_ssl_session_reset(&ssl);
-	mbedtls_ssl_set_bio(&ssl, &ctx, ssl_tx, ssl_rx, NULL);
-	/*
-	 * 5. Handshake
-	 */
-	do {
-		ret = mbedtls_ssl_handshake(&ssl);
-		if (ret != MBEDTLS_ERR_SSL_WANT_READ &&
-		    ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
-			if (ret < 0) {
-				mbedtls_printf(" failed\n  !"
-					       " mbedtls_ssl_handshake returned %d\n\n",
-					       ret);
-				goto reset;
-			}
-		}
-	} while (ret != 0);
 
 	/*
-	 * 6. Read the HTTPS Request
+	 * 5. Serve whichever connections have received data
 	 */
-	mbedtls_printf("Read HTTPS request\n");
-	do {
-		len = sizeof(payload) - 1;
-		memset(payload, 0, sizeof(payload));
-		ret = mbedtls_ssl_read(&ssl, payload, len);
+	while (1) {
+		k_poll(events, SSL_MAX_CONNECTIONS, K_FOREVER);
 
-		if (ret == MBEDTLS_ERR_SSL_WANT_READ ||
-		    ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
-			continue;
-		}
-
-		if (ret <= 0) {
-			switch (ret) {
-			case MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY:
-				mbedtls_printf(" connection was"
-					       " closed gracefully\n");
-				goto close;
-
-			case MBEDTLS_ERR_NET_CONN_RESET:
-				mbedtls_printf(" connection was"
-					       " reset by peer\n");
-				break;
-
-			default:
-				mbedtls_printf
-				    (" mbedtls_ssl_read returned -0x%x\n",
-				     -ret);
-				break;
+		for (i = 0; i < SSL_MAX_CONNECTIONS; i++) {
+			if (events[i].state !=
+			    K_POLL_STATE_FIFO_DATA_AVAILABLE) {
+				continue;
 			}
 
-			break;
-		}
-
-		len = ret;
-		ret = http_parser_execute(&ctx.parser, &ctx.parser_settings,
-					  payload, len);
-		if (ret < 0) {
+			events[i].state = K_POLL_STATE_NOT_READY;
+			tls_conn_process(i);
 		}
-	} while (ret < 0);
-
-	/*
-	 * 7. Write the Response
-	 */
-	mbedtls_printf("Write HTTPS response\n");
-
-	if (!strncmp("/index.html", request.url, request.url_len)) {
-		len = snprintf((char *)payload, sizeof(payload),
-				HTTP_RESPONSE);
-	} else {
-
-		len = snprintf((char *)payload, sizeof(payload),
-				HTTP_NOT_FOUND);
 	}
 
-	do {
-		ret = mbedtls_ssl_write(&ssl, payload, len);
-		if (ret == MBEDTLS_ERR_NET_CONN_RESET) {
-			mbedtls_printf(" failed\n  !"
-				       " peer closed the connection\n");
-			goto reset;
-		}
-
-		if (ret != MBEDTLS_ERR_SSL_WANT_READ &&
-		    ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
-			if (ret < 0) {
-				mbedtls_printf(" failed\n  !"
-					       " mbedtls_ssl_write"
-					       " returned %d\n", ret);
-				goto exit;
-			}
-		}
-	} while (ret <= 0);
-
-close:
-
-	mbedtls_ssl_close_notify(&ssl);
-	ret = 0;
-	goto reset;
-
 exit:
 #ifdef MBEDTLS_ERROR_C
 	if (ret != 0) {
-		mbedtls_strerror(ret, payload, 100);
+		mbedtls_strerror(ret, (char *)payload, 100);
 		mbedtls_printf("Last error was: %d - %s\n", ret, payload);
 	}
 #endif
 
-	mbedtls_ssl_free(&ssl);
+	for (i = 0; i < SSL_MAX_CONNECTIONS; i++) {
+		mbedtls_ssl_free(&conns[i].ssl);
+	}
 	mbedtls_ssl_config_free(&conf);
+#if defined(MBEDTLS_SSL_CACHE_C)
+	mbedtls_ssl_cache_free(&cache);
+#endif
 	mbedtls_ctr_drbg_free(&ctr_drbg);
 	mbedtls_entropy_free(&entropy);
 }
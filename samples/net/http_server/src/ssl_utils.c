@@ -26,7 +26,13 @@
 
 #define RX_FIFO_DEPTH 4
 
-K_MEM_POOL_DEFINE(rx_pkts, 4, 64, RX_FIFO_DEPTH, 4);
+K_MEM_POOL_DEFINE(rx_pkts, 4, 64, RX_FIFO_DEPTH * SSL_MAX_CONNECTIONS, 4);
+
+static struct {
+	struct net_context *net_ctx;
+	struct ssl_context *conns;
+	int count;
+} listener;
 
 static void ssl_received(struct net_context *context,
 			 struct net_buf *buf, int status, void *user_data)
@@ -38,7 +44,10 @@ static void ssl_received(struct net_context *context,
 	ARG_UNUSED(context);
 	ARG_UNUSED(status);
 
-	if (!net_nbuf_appdatalen(buf)) {
+	/* A NULL buffer means the peer closed the connection, it is queued
+	 * so that ssl_rx() reports end of stream in order.
+	 */
+	if (buf && !net_nbuf_appdatalen(buf)) {
 		net_nbuf_unref(buf);
 		return;
 	}
@@ -106,10 +115,18 @@ int ssl_rx(void *context, unsigned char *buf, size_t size)
 	int rc = 0;
 
 	if (ctx->frag == NULL) {
-		rx_data = k_fifo_get(&ctx->rx_fifo, K_FOREVER);
+		rx_data = k_fifo_get(&ctx->rx_fifo, K_NO_WAIT);
+		if (!rx_data) {
+			return MBEDTLS_ERR_SSL_WANT_READ;
+		}
+
 		ctx->rx_nbuf = rx_data->buf;
 		k_mem_pool_free(&rx_data->block);
 
+		if (!ctx->rx_nbuf) {
+			return 0;
+		}
+
 		read_bytes = net_nbuf_appdatalen(ctx->rx_nbuf);
 
 		ctx->remaining = read_bytes;
@@ -173,15 +190,54 @@ int ssl_rx(void *context, unsigned char *buf, size_t size)
 	return rc;
 }
 
+void ssl_close(struct ssl_context *ctx)
+{
+	struct rx_fifo_block *rx_data;
+
+	net_context_put(ctx->net_ctx);
+
+	while ((rx_data = k_fifo_get(&ctx->rx_fifo, K_NO_WAIT))) {
+		if (rx_data->buf) {
+			net_nbuf_unref(rx_data->buf);
+		}
+
+		k_mem_pool_free(&rx_data->block);
+	}
+
+	if (ctx->rx_nbuf) {
+		net_nbuf_unref(ctx->rx_nbuf);
+	}
+
+	ctx->rx_nbuf = NULL;
+	ctx->frag = NULL;
+	ctx->remaining = 0;
+
+	/* Make the slot available to ssl_accepted() again */
+	ctx->net_ctx = NULL;
+}
+
 static void ssl_accepted(struct net_context *context,
 			 struct sockaddr *addr,
 			 socklen_t addrlen, int error, void *user_data)
 {
-	int ret;
-	struct ssl_context *ctx = user_data;
+	struct ssl_context *ctx = NULL;
+	int i, ret;
+
+	for (i = 0; i < listener.count; i++) {
+		if (!listener.conns[i].net_ctx) {
+			ctx = &listener.conns[i];
+			break;
+		}
+	}
+
+	if (!ctx) {
+		printk("No free TLS connection, dropping client\n");
+		net_context_put(context);
+		return;
+	}
 
 	ctx->net_ctx = context;
-	ret = net_context_recv(context, ssl_received, 0, user_data);
+	ret = net_context_recv(context, ssl_received, 0, ctx);
 	if (ret < 0) {
 		printk("Cannot receive TCP packet (family %d)",
 		       net_context_get_family(context));
@@ -189,18 +245,32 @@ static void ssl_accepted(struct net_context *context,
 
 }
 
+static void ssl_conns_init(struct ssl_context *ctx, int count)
+{
+	int i;
+
+	listener.conns = ctx;
+	listener.count = count;
+
+	for (i = 0; i < count; i++) {
+		k_sem_init(&ctx[i].tx_sem, 0, UINT_MAX);
+		k_fifo_init(&ctx[i].rx_fifo);
+		ctx[i].net_ctx = NULL;
+		ctx[i].rx_nbuf = NULL;
+		ctx[i].frag = NULL;
+		ctx[i].remaining = 0;
+	}
+}
+
 #if defined(CONFIG_NET_IPV6)
-int ssl_init(struct ssl_context *ctx, void *addr)
+int ssl_init(struct ssl_context *ctx, int count, void *addr)
 {
 	struct net_context *tcp_ctx = { 0 };
 	struct sockaddr_in6 my_addr = { 0 };
 	struct in6_addr *server_addr = addr;
 	int rc;
 
-	k_sem_init(&ctx->tx_sem, 0, UINT_MAX);
-	k_fifo_init(&ctx->rx_fifo);
-
-	my_mcast_addr.sin6_family = AF_INET6;
+	ssl_conns_init(ctx, count);
 
 	net_ipaddr_copy(&my_addr.sin6_addr, server_addr);
 	my_addr.sin6_family = AF_INET6;
@@ -219,17 +289,15 @@ int ssl_init(struct ssl_context *ctx, void *addr)
 		goto error;
 	}
 
-	ctx->rx_nbuf = NULL;
-	ctx->remaining = 0;
-	ctx->net_ctx = tcp_ctx;
+	listener.net_ctx = tcp_ctx;
 
-	rc = net_context_listen(ctx->net_ctx, 0);
+	rc = net_context_listen(listener.net_ctx, 0);
 	if (rc < 0) {
 		printk("Cannot listen IPv6 TCP (%d)", rc);
 		return -EIO;
 	}
 
-	rc = net_context_accept(ctx->net_ctx, ssl_accepted, 0, ctx);
+	rc = net_context_accept(listener.net_ctx, ssl_accepted, 0, NULL);
 	if (rc < 0) {
 		printk("Cannot accept IPv4 (%d)", rc);
 		return -EIO;
@@ -243,15 +311,14 @@ error:
 }
 
 #else
-int ssl_init(struct ssl_context *ctx, void *addr)
+int ssl_init(struct ssl_context *ctx, int count, void *addr)
 {
 	struct net_context *tcp_ctx = { 0 };
 	struct sockaddr_in my_addr4 = { 0 };
 	struct in_addr *server_addr = addr;
 	int rc;
 
-	k_sem_init(&ctx->tx_sem, 0, UINT_MAX);
-	k_fifo_init(&ctx->rx_fifo);
+	ssl_conns_init(ctx, count);
 
 	net_ipaddr_copy(&my_addr4.sin_addr, server_addr);
 	my_addr4.sin_family = AF_INET;
@@ -270,17 +337,15 @@ int ssl_init(struct ssl_context *ctx, void *addr)
 		goto error;
 	}
 
-	ctx->rx_nbuf = NULL;
-	ctx->remaining = 0;
-	ctx->net_ctx = tcp_ctx;
+	listener.net_ctx = tcp_ctx;
 
-	rc = net_context_listen(ctx->net_ctx, 0);
+	rc = net_context_listen(listener.net_ctx, 0);
 	if (rc < 0) {
 		printk("Cannot listen IPv4 (%d)", rc);
 		return -EIO;
 	}
 
-	rc = net_context_accept(ctx->net_ctx, ssl_accepted, 0, ctx);
+	rc = net_context_accept(listener.net_ctx, ssl_accepted, 0, NULL);
 	if (rc < 0) {
 		printk("Cannot accept IPv4 (%d)", rc);
 		return -EIO;
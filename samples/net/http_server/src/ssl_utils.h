@@ -28,7 +28,11 @@ struct ssl_context {
 	int remaining;
 };
 
-int ssl_init(struct ssl_context *ctx, void *addr);
+/* Listen on addr and hand accepted connections out to the free slots of
+ * the ctx array, which must hold count entries.
+ */
+int ssl_init(struct ssl_context *ctx, int count, void *addr);
+void ssl_close(struct ssl_context *ctx);
 int ssl_tx(void *ctx, const unsigned char *buf, size_t size);
 int ssl_rx(void *ctx, unsigned char *buf, size_t size);
 
@@ -31,6 +31,9 @@
 #include <string.h>
 #include <net/net_context.h>
 #include <net/net_if.h>
+#if defined(CONFIG_ENTROPY_POOL)
+#include <entropy_pool.h>
+#endif
 #include "udp.h"
 #include "udp_cfg.h"
 
@@ -131,6 +134,16 @@ int dtls_timing_get_delay(void *data)
 static int entropy_source(void *data, unsigned char *output, size_t len,
 			  size_t *olen)
 {
+#if defined(CONFIG_ENTROPY_POOL)
+	ARG_UNUSED(data);
+
+	if (entropy_pool_get(output, len, K_FOREVER)) {
+		return MBEDTLS_ERR_ENTROPY_SOURCE_FAILED;
+	}
+
+	*olen = len;
+	return 0;
+#else
 	uint32_t seed;
 
 	seed = sys_rand32_get();
@@ -142,6 +155,7 @@ static int entropy_source(void *data, unsigned char *output, size_t len,
 
 	*olen = len;
 	return 0;
+#endif
 }
 
 void dtls_client(void)
@@ -32,6 +32,9 @@
 #include <string.h>
 #include <net/net_context.h>
 #include <net/net_if.h>
+#if defined(CONFIG_ENTROPY_POOL)
+#include <entropy_pool.h>
+#endif
 #include "udp.h"
 #include "udp_cfg.h"
 
@@ -50,6 +53,10 @@
 static unsigned char heap[20480];
 #endif
 
+#if defined(CONFIG_MBEDTLS_ECP_POOL)
+#include "zephyr_ecp_pool.h"
+#endif
+
 #define DEBUG_THRESHOLD 0
 /*
  * Hardcoded values for server host and port
@@ -123,6 +130,16 @@ int dtls_timing_get_delay(void *data)
 static int entropy_source(void *data, unsigned char *output, size_t len,
 			  size_t *olen)
 {
+#if defined(CONFIG_ENTROPY_POOL)
+	ARG_UNUSED(data);
+
+	if (entropy_pool_get(output, len, K_FOREVER)) {
+		return MBEDTLS_ERR_ENTROPY_SOURCE_FAILED;
+	}
+
+	*olen = len;
+	return 0;
+#else
 	uint32_t seed;
 	char *ptr = data;
 
@@ -143,6 +160,7 @@ static int entropy_source(void *data, unsigned char *output, size_t len,
 
 	*olen = len;
 	return 0;
+#endif
 }
 
 unsigned char payload[256];
@@ -150,6 +168,7 @@ unsigned char payload[256];
 void dtls_server(void)
 {
 	int len, ret = 0;
+	uint32_t start, elapsed_ms;
 	struct udp_context ctx;
 	struct dtls_timing_context timer;
 
@@ -208,6 +227,16 @@ void dtls_server(void)
 
 #if defined(MBEDTLS_MEMORY_BUFFER_ALLOC_C)
 	mbedtls_memory_buffer_alloc_init(heap, sizeof(heap));
+#endif
+#if defined(CONFIG_MBEDTLS_ECP_POOL)
+	/* ECJPAKE runs on secp256r1, its round one keys come from the pool */
+	ret = zephyr_ecp_pool_init(MBEDTLS_ECP_DP_SECP256R1,
+				   mbedtls_ctr_drbg_random, &ctr_drbg);
+	if (ret != 0) {
+		mbedtls_printf(" failed\n  ! zephyr_ecp_pool_init returned"
+			       " -0x%x\n", -ret);
+		goto exit;
+	}
 #endif
 	ret = mbedtls_ssl_cookie_setup(&cookie_ctx, mbedtls_ctr_drbg_random,
 				       &ctr_drbg);
@@ -277,6 +306,7 @@ reset:
 
 	mbedtls_printf("  . Performing the TLS handshake...");
 
+	start = k_cycle_get_32();
 	do {
 		ret = mbedtls_ssl_handshake(&ssl);
 	} while (ret == MBEDTLS_ERR_SSL_WANT_READ ||
@@ -295,7 +325,9 @@ reset:
 		goto reset;
 	}
 
-	mbedtls_printf(" ok\n");
+	elapsed_ms = SYS_CLOCK_HW_CYCLES_TO_NS64(k_cycle_get_32() - start) /
+		     (NSEC_PER_USEC * USEC_PER_MSEC);
+	mbedtls_printf(" ok (%u ms)\n", elapsed_ms);
 
 	do {
 		/* Read the request */
@@ -360,6 +392,10 @@ close_notify:
 	goto reset;
 
 exit:
+#if defined(CONFIG_MBEDTLS_ECP_POOL)
+	/* The pool thread draws from ctr_drbg */
+	zephyr_ecp_pool_deinit();
+#endif
 	mbedtls_ssl_free(&ssl);
 	mbedtls_ssl_config_free(&conf);
 	mbedtls_ctr_drbg_free(&ctr_drbg);
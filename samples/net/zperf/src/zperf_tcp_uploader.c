@@ -70,8 +70,8 @@ void zperf_tcp_upload(struct net_context *ctx,
 		net_buf_frag_add(buf, frag);
 
 		/* Fill in the TCP payload */
-		st = net_nbuf_append(buf, sizeof(sample_packet),
-				     sample_packet, K_FOREVER);
+		st = net_nbuf_append(buf, packet_size, sample_packet,
+				     K_FOREVER);
 		if (!st) {
 			printk(TAG "ERROR! Failed to fill packet\n");
 
@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2017 Intel Corporation
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Zero latency ISR call checker. Zero latency interrupts are not masked by
+# irq_lock(), so their ISRs may not use any kernel service. The linker
+# script gathers these ISRs, and the functions declared __zli_text for them
+# to call, between the _zli_text_start and _zli_text_end symbols.
+#
+# This reads the output of "objdump -d -t" for the kernel ELF and fails if
+# code in that range calls or branches to code outside of it, or calls
+# through a function pointer. Compiler support routines (__aeabi_*) are
+# allowed.
+#
+# With --intlist, the .intList section extracted for gen_isr_tables.py, it
+# also fails if an IRQ connected with IRQ_ZERO_LATENCY has its handler
+# outside of that range, e.g. one declared with ISR_DIRECT_DECLARE(), whose
+# header and footer run kernel code.
+
+import argparse
+import re
+import struct
+import sys
+
+symbol_re = re.compile(r'^([0-9a-f]+)\s.*\s(_zli_text_start|_zli_text_end)$')
+function_re = re.compile(r'^([0-9a-f]+) <(.+)>:$')
+target_re = re.compile(r'^([0-9a-f]+) <([^>+]+)')
+register_re = re.compile(r'^(r[0-9]+|ip|lr|sl|fp)$')
+
+ALLOWED_PREFIXES = ("__aeabi_",)
+
+# See include/sw_isr_table.h and read_intlist() in gen_isr_tables.py
+ISR_FLAG_ZERO_LATENCY = (1 << 1)
+INTLIST_HEADER_FMT = "<IIIII"
+INTLIST_ENTRY_FMT = "<iiII"
+
+
+def check_intlist(path, start, end):
+    errors = []
+
+    with open(path, "rb") as fp:
+        intdata = fp.read()
+
+    intdata = intdata[struct.calcsize(INTLIST_HEADER_FMT):]
+
+    for irq, flags, func, param in struct.iter_unpack(INTLIST_ENTRY_FMT,
+                                                      intdata):
+        if not flags & ISR_FLAG_ZERO_LATENCY:
+            continue
+
+        # Clear the Thumb bit of the handler address
+        if not start <= (func & ~1) < end:
+            errors.append("irq %d handler 0x%x is not declared with "
+                          "ISR_ZERO_LATENCY_DECLARE()" % (irq, func))
+
+    return errors
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Check that zero latency ISRs do not call kernel code")
+    parser.add_argument("-i", "--intlist",
+                        help=".intList section of the kernel, as binary")
+    args = parser.parse_args()
+
+    symbols = {}
+    errors = []
+    function = None
+
+    for line in sys.stdin:
+        line = line.rstrip()
+
+        match = symbol_re.match(line)
+        if match:
+            symbols[match.group(2)] = int(match.group(1), 16)
+            continue
+
+        match = function_re.match(line)
+        if match:
+            function = match.group(2)
+            continue
+
+        # Instruction lines are "<addr>:\t<opcode>\t<mnemonic>\t<operands>"
+        fields = line.split("\t")
+        if len(fields) < 4 or not fields[0].strip().endswith(":"):
+            continue
+
+        if len(symbols) != 2:
+            sys.exit("check_zli_calls.py: _zli_text_start/_zli_text_end "
+                     "not found")
+
+        addr = int(fields[0].strip()[:-1], 16)
+        if not symbols["_zli_text_start"] <= addr < symbols["_zli_text_end"]:
+            continue
+
+        mnemonic = fields[2].strip()
+        operands = fields[3].strip()
+        if not mnemonic.startswith("b"):
+            continue
+
+        if mnemonic == "blx" and register_re.match(operands):
+            errors.append("%s calls through a function pointer" % function)
+            continue
+
+        match = target_re.match(operands)
+        if not match:
+            continue
+
+        target = int(match.group(1), 16)
+        name = match.group(2)
+        if symbols["_zli_text_start"] <= target < symbols["_zli_text_end"]:
+            continue
+
+        if name.startswith(ALLOWED_PREFIXES):
+            continue
+
+        errors.append("%s calls %s, which is not __zli_text" %
+                      (function, name))
+
+    if len(symbols) != 2:
+        sys.exit("check_zli_calls.py: _zli_text_start/_zli_text_end "
+                 "not found")
+
+    if args.intlist:
+        errors += check_intlist(args.intlist, symbols["_zli_text_start"],
+                                symbols["_zli_text_end"])
+
+    for error in sorted(set(errors)):
+        sys.stderr.write("ERROR: zero latency ISR code: %s\n" % error)
+
+    if errors:
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,257 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2017 Intel Corporation
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Simulated IEEE 802.15.4 medium for QEMU instances using the UART pipe
+# radio driver (CONFIG_IEEE802154_UPIPE).
+#
+# Every node is a QEMU started with "-serial pipe:<base>-<n>", so what
+# the node sends shows up in <base>-<n>.out and what it receives is read
+# from <base>-<n>.in. Frames are a 0xf0 byte, a length byte and the PSDU
+# without FCS. A frame sent by one node is delivered to each of its
+# neighbours, unless the link drops it, after the latency of that link.
+#
+# The topology file has one link per line, "<a> <b> [loss] [latency]",
+# with the loss probability between 0 and 1 and the latency in
+# milliseconds. Links are symmetric, '#' starts a comment. Without a
+# topology file all nodes hear each other.
+#
+# Example, a chain of three nodes with a lossy middle hop:
+#
+#     1 2
+#     2 3 0.1 5
+#
+# Start the medium first, then "make node NODE=<n>" for each node in
+# the sample directory.
+
+import argparse
+import errno
+import heapq
+import os
+import random
+import select
+import signal
+import struct
+import sys
+import time
+
+FRAME_TYPE = 0xf0
+MAX_PSDU = 127
+
+# LINKTYPE_IEEE802_15_4_NOFCS
+PCAP_LINKTYPE = 230
+
+
+class Link:
+    def __init__(self, loss, latency):
+        self.loss = loss
+        self.latency = latency
+        self.delivered = 0
+        self.dropped = 0
+
+
+class Node:
+    def __init__(self, num, base):
+        self.num = num
+        self.tx = 0
+        self.rx = 0
+        self.bad = 0
+        self.links = {}
+
+        # O_RDWR keeps the open from blocking until QEMU shows up, and
+        # keeps the FIFO alive when QEMU restarts.
+        path = "%s-%d" % (base, num)
+        for suffix in (".in", ".out"):
+            if not os.path.exists(path + suffix):
+                os.mkfifo(path + suffix)
+        self.fd_in = os.open(path + ".in", os.O_RDWR | os.O_NONBLOCK)
+        self.fd_out = os.open(path + ".out", os.O_RDWR | os.O_NONBLOCK)
+
+        self.buf = bytearray()
+
+    def frames(self, data):
+        self.buf += data
+
+        while self.buf:
+            # Resynchronise on the next frame start after garbage
+            if self.buf[0] != FRAME_TYPE:
+                start = self.buf.find(bytes([FRAME_TYPE]))
+                self.bad += 1
+                if start < 0:
+                    del self.buf[:]
+                    return
+                del self.buf[:start]
+                continue
+
+            if len(self.buf) < 2:
+                return
+
+            length = self.buf[1]
+            if length > MAX_PSDU:
+                self.bad += 1
+                del self.buf[:1]
+                continue
+
+            if len(self.buf) < 2 + length:
+                return
+
+            frame = bytes(self.buf[2:2 + length])
+            del self.buf[:2 + length]
+            self.tx += 1
+
+            yield frame
+
+    def deliver(self, frame):
+        data = bytes([FRAME_TYPE, len(frame)]) + frame
+
+        try:
+            os.write(self.fd_in, data)
+            self.rx += 1
+        except OSError as e:
+            # Nobody is draining the pipe, the node is gone or stuck
+            if e.errno != errno.EAGAIN:
+                raise
+
+
+class Pcap:
+    def __init__(self, path):
+        self.f = open(path, "wb")
+        self.f.write(struct.pack("<IHHiIII", 0xa1b2c3d4, 2, 4, 0, 0,
+                                 65535, PCAP_LINKTYPE))
+
+    def write(self, frame):
+        now = time.time()
+        sec = int(now)
+        usec = int((now - sec) * 1000000)
+
+        self.f.write(struct.pack("<IIII", sec, usec, len(frame),
+                                 len(frame)))
+        self.f.write(frame)
+        self.f.flush()
+
+
+def parse_topology(path, nodes):
+    links = []
+
+    with open(path) as f:
+        for lineno, line in enumerate(f, 1):
+            fields = line.split("#", 1)[0].split()
+            if not fields:
+                continue
+
+            if len(fields) < 2 or len(fields) > 4:
+                sys.exit("%s:%d: expected <a> <b> [loss] [latency]" %
+                         (path, lineno))
+
+            a, b = int(fields[0]), int(fields[1])
+            if a not in nodes or b not in nodes or a == b:
+                sys.exit("%s:%d: bad link %d-%d" % (path, lineno, a, b))
+
+            loss = float(fields[2]) if len(fields) > 2 else None
+            latency = float(fields[3]) if len(fields) > 3 else None
+            links.append((a, b, loss, latency))
+
+    return links
+
+
+def print_stats(nodes):
+    print("node     tx     rx    bad")
+    for n in nodes.values():
+        print("%4d %6d %6d %6d" % (n.num, n.tx, n.rx, n.bad))
+
+    print("link        delivered dropped")
+    for n in nodes.values():
+        for peer, link in sorted(n.links.items()):
+            print("%4d -> %-4d %9d %7d" % (n.num, peer, link.delivered,
+                                          link.dropped))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Simulated IEEE 802.15.4 medium for QEMU nodes")
+    parser.add_argument("-n", "--nodes", type=int, default=2,
+                        help="number of nodes, numbered from 1")
+    parser.add_argument("-b", "--base", default="/tmp/ip-stack-node",
+                        help="pipe name prefix, node n uses <base>-<n>")
+    parser.add_argument("-t", "--topology",
+                        help="link list, all nodes are neighbours without")
+    parser.add_argument("-l", "--loss", type=float, default=0.0,
+                        help="default frame loss probability of a link")
+    parser.add_argument("-d", "--latency", type=float, default=0.0,
+                        help="default link latency in milliseconds")
+    parser.add_argument("-p", "--pcap",
+                        help="record every frame sent to this file")
+    parser.add_argument("-s", "--seed", type=int,
+                        help="random seed, to replay the same losses")
+    args = parser.parse_args()
+
+    rand = random.Random(args.seed)
+
+    nodes = {}
+    for num in range(1, args.nodes + 1):
+        nodes[num] = Node(num, args.base)
+
+    if args.topology:
+        links = parse_topology(args.topology, nodes)
+    else:
+        links = [(a, b, None, None) for a in nodes for b in nodes if a < b]
+
+    for a, b, loss, latency in links:
+        if loss is None:
+            loss = args.loss
+        if latency is None:
+            latency = args.latency
+
+        nodes[a].links[b] = Link(loss, latency / 1000.0)
+        nodes[b].links[a] = Link(loss, latency / 1000.0)
+
+    pcap = Pcap(args.pcap) if args.pcap else None
+
+    by_fd = {n.fd_out: n for n in nodes.values()}
+    pending = []
+    seq = 0
+
+    def stop(signum, frame):
+        print_stats(nodes)
+        sys.exit(0)
+
+    signal.signal(signal.SIGINT, stop)
+    signal.signal(signal.SIGTERM, stop)
+
+    while True:
+        timeout = None
+        if pending:
+            timeout = max(pending[0][0] - time.time(), 0)
+
+        readable, _, _ = select.select(list(by_fd), [], [], timeout)
+
+        for fd in readable:
+            sender = by_fd[fd]
+
+            for frame in sender.frames(os.read(fd, 4096)):
+                if pcap:
+                    pcap.write(frame)
+
+                now = time.time()
+                for peer, link in sender.links.items():
+                    if rand.random() < link.loss:
+                        link.dropped += 1
+                        continue
+
+                    link.delivered += 1
+
+                    # seq keeps frames on one link in order
+                    heapq.heappush(pending, (now + link.latency, seq,
+                                             peer, frame))
+                    seq += 1
+
+        now = time.time()
+        while pending and pending[0][0] <= now:
+            _, _, peer, frame = heapq.heappop(pending)
+            nodes[peer].deliver(frame)
+
+
+if __name__ == "__main__":
+    main()
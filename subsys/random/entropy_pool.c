@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <errno.h>
+#include <entropy_pool.h>
+
+#if defined(CONFIG_RANDOM_NAME)
+#include <device.h>
+#include <random.h>
+#else
+#include <drivers/rand32.h>
+#endif
+
+#if CONFIG_ENTROPY_POOL_SIZE % 16
+#error "CONFIG_ENTROPY_POOL_SIZE must be a multiple of 16"
+#endif
+
+/* Bytes read from the source at a time */
+#define HARVEST_CHUNK		16
+
+/* Refill when this much or less is left */
+#define POOL_LOW_WATERMARK	(CONFIG_ENTROPY_POOL_SIZE / 2)
+
+/* Back off after the source failed or a health test tripped */
+#define HARVEST_RETRY_MSEC	10
+
+/*
+ * NIST SP 800-90B 4.4 continuous health tests, on byte samples with an
+ * assumed min-entropy of 1 bit per byte (alpha = 2^-20).
+ */
+#define RCT_CUTOFF		21
+#define APT_WINDOW		512
+#define APT_CUTOFF		410
+
+static uint8_t pool[CONFIG_ENTROPY_POOL_SIZE];
+static uint16_t pool_head;
+static uint16_t pool_count;
+
+static struct entropy_pool_stats stats;
+
+static struct {
+	uint8_t rct_sample;
+	uint8_t rct_count;
+	uint8_t apt_sample;
+	uint16_t apt_count;
+	uint16_t apt_seen;
+} health;
+
+/* Wakes the harvester, and tells consumers that it produced data */
+K_SEM_DEFINE(refill_sem, 1, 1);
+K_SEM_DEFINE(data_sem, 0, 1);
+
+/* Keeps concurrent requests from interleaving */
+K_MUTEX_DEFINE(get_mutex);
+
+static bool health_test(uint8_t sample)
+{
+	bool ok = true;
+
+	if (health.rct_count && sample == health.rct_sample) {
+		if (++health.rct_count >= RCT_CUTOFF) {
+			ok = false;
+		}
+	} else {
+		health.rct_sample = sample;
+		health.rct_count = 1;
+	}
+
+	if (!health.apt_seen) {
+		health.apt_sample = sample;
+		health.apt_count = 1;
+	} else if (sample == health.apt_sample) {
+		if (++health.apt_count >= APT_CUTOFF) {
+			ok = false;
+		}
+	}
+
+	if (++health.apt_seen == APT_WINDOW) {
+		health.apt_seen = 0;
+	}
+
+	return ok;
+}
+
+#if defined(CONFIG_RANDOM_NAME)
+static struct device *source;
+
+static int harvest(uint8_t *buf, uint16_t len)
+{
+	if (!source) {
+		source = device_get_binding(CONFIG_RANDOM_NAME);
+		if (!source) {
+			return -ENODEV;
+		}
+	}
+
+	return random_get_entropy(source, buf, len);
+}
+#else
+static int harvest(uint8_t *buf, uint16_t len)
+{
+	uint32_t value;
+	uint16_t n;
+
+	while (len) {
+		value = sys_rand32_get();
+		n = min(len, sizeof(value));
+		memcpy(buf, &value, n);
+		buf += n;
+		len -= n;
+	}
+
+	return 0;
+}
+#endif
+
+static void entropy_pool_harvest(void)
+{
+	uint8_t chunk[HARVEST_CHUNK];
+	uint16_t tail, space;
+	unsigned int key;
+	bool ok;
+	int i;
+
+	while (1) {
+		k_sem_take(&refill_sem, K_FOREVER);
+
+		while (1) {
+			key = irq_lock();
+			space = sizeof(pool) - pool_count;
+			irq_unlock(key);
+
+			if (space < HARVEST_CHUNK) {
+				break;
+			}
+
+			if (harvest(chunk, sizeof(chunk))) {
+				k_sleep(HARVEST_RETRY_MSEC);
+				continue;
+			}
+
+			ok = true;
+			for (i = 0; i < sizeof(chunk); i++) {
+				ok &= health_test(chunk[i]);
+			}
+
+			if (!ok) {
+				stats.discarded += sizeof(chunk);
+				k_sleep(HARVEST_RETRY_MSEC);
+				continue;
+			}
+
+			/* Chunks never wrap, the pool size is a multiple */
+			key = irq_lock();
+			tail = (pool_head + pool_count) % sizeof(pool);
+			memcpy(&pool[tail], chunk, sizeof(chunk));
+			pool_count += sizeof(chunk);
+			irq_unlock(key);
+
+			stats.harvested += sizeof(chunk);
+			k_sem_give(&data_sem);
+		}
+
+		memset(chunk, 0, sizeof(chunk));
+	}
+}
+
+K_THREAD_DEFINE(entropy_pool_thread, CONFIG_ENTROPY_POOL_STACK_SIZE,
+		entropy_pool_harvest, NULL, NULL, NULL,
+		CONFIG_ENTROPY_POOL_THREAD_PRIORITY, 0, K_NO_WAIT);
+
+int entropy_pool_get(uint8_t *buffer, size_t length, int32_t timeout)
+{
+	unsigned int key;
+	uint16_t n;
+	bool low;
+
+	k_mutex_lock(&get_mutex, K_FOREVER);
+
+	while (length) {
+		key = irq_lock();
+
+		n = min(length, pool_count);
+		n = min(n, sizeof(pool) - pool_head);
+
+		memcpy(buffer, &pool[pool_head], n);
+		memset(&pool[pool_head], 0, n);
+
+		pool_head = (pool_head + n) % sizeof(pool);
+		pool_count -= n;
+		low = pool_count <= POOL_LOW_WATERMARK;
+
+		irq_unlock(key);
+
+		stats.served += n;
+		buffer += n;
+		length -= n;
+
+		if (low) {
+			k_sem_give(&refill_sem);
+		}
+
+		if (length && !n && k_sem_take(&data_sem, timeout)) {
+			k_mutex_unlock(&get_mutex);
+			return -EAGAIN;
+		}
+	}
+
+	k_mutex_unlock(&get_mutex);
+
+	return 0;
+}
+
+void entropy_pool_stats_get(struct entropy_pool_stats *out)
+{
+	unsigned int key;
+
+	key = irq_lock();
+	memcpy(out, &stats, sizeof(stats));
+	irq_unlock(key);
+}
@@ -156,10 +156,14 @@ void main(void)
 		test_result += lifo_test();
 		test_result += fifo_test();
 		test_result += stack_test();
+		test_result += yield_test();
 
 		if (test_result) {
-			/* sema/lifo/fifo/stack account for 12 tests in total */
-			if (test_result == 12) {
+			/*
+			 * sema/lifo/fifo/stack/yield account for 14 tests
+			 * in total
+			 */
+			if (test_result == 14) {
 				fprintf(output_file, sz_module_result_fmt,
 					sz_success);
 			} else {
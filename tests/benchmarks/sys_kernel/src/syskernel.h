@@ -47,6 +47,7 @@ int sema_test(void);
 int lifo_test(void);
 int fifo_test(void);
 int stack_test(void);
+int yield_test(void);
 void begin_test(void);
 
 static inline uint32_t BENCH_START(void)
@@ -0,0 +1,91 @@
+/* yield.c */
+
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "syskernel.h"
+
+/**
+ *
+ * @brief Yield test thread
+ *
+ * @param par1   Address of the counter.
+ * @param par2   Number of test cycles.
+ *
+ * @return N/A
+ */
+void yield_thread(void *par1, void *par2, void *par3)
+{
+	int i;
+	int *pcounter = (int *)par1;
+	int num_loops = (int) par2;
+
+	ARG_UNUSED(par3);
+
+	for (i = 0; i < num_loops; i++) {
+		k_yield();
+		(*pcounter)++;
+	}
+}
+
+
+/**
+ *
+ * @brief The main test entry
+ *
+ * @return 1 if success and 0 on failure
+ */
+int yield_test(void)
+{
+	uint32_t t;
+	int i = 0;
+	int return_value = 0;
+
+	fprintf(output_file, sz_test_case_fmt,
+			"Yield #1");
+	fprintf(output_file, sz_description,
+			"\n\tk_yield (no other thread ready)");
+	printf(sz_test_start_fmt);
+
+	t = BENCH_START();
+
+	for (i = 0; i < NUMBER_OF_LOOPS; i++) {
+		k_yield();
+	}
+
+	t = TIME_STAMP_DELTA_GET(t);
+
+	return_value += check_result(i, t);
+
+	fprintf(output_file, sz_test_case_fmt,
+			"Yield #2");
+	fprintf(output_file, sz_description,
+			"\n\tk_yield (to another thread)");
+	printf(sz_test_start_fmt);
+
+	i = 0;
+
+	t = BENCH_START();
+
+	/*
+	 * let both threads be ready before the first one runs; each does
+	 * half of the yields, so that i counts NUMBER_OF_LOOPS in total
+	 */
+	k_sched_lock();
+	k_thread_spawn(thread_stack1, STACK_SIZE, yield_thread,
+			 (void *) &i, (void *) (NUMBER_OF_LOOPS / 2), NULL,
+			 K_PRIO_COOP(3), 0, K_NO_WAIT);
+	k_thread_spawn(thread_stack2, STACK_SIZE, yield_thread,
+			 (void *) &i, (void *) (NUMBER_OF_LOOPS / 2), NULL,
+			 K_PRIO_COOP(3), 0, K_NO_WAIT);
+	k_sched_unlock();
+
+	t = TIME_STAMP_DELTA_GET(t);
+
+	return_value += check_result(i, t);
+
+	return return_value;
+}
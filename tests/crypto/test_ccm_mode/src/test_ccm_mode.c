@@ -43,6 +43,8 @@
  *  - AES128 CCM mode encryption RFC 3610 test vector #9
  *  - AES128 CCM mode encryption No associated data
  * - AES128 CCM mode encryption No payhoad data
+ *  - AES128 CCM mode in-place streaming over fragments, with a per-frame
+ *    cycle count against the one-shot routines
  */
 
 #include <tinycrypt/ccm_mode.h>
@@ -66,6 +68,10 @@
 #define EXPECTED_BUF_LEN33 33
 #define EXPECTED_BUF_LEN34 34
 #define EXPECTED_BUF_LEN35 35
+#define FRAME_LEN 127 /* largest IEEE 802.15.4 frame */
+#define FRAME_HDR_LEN 23
+#define FRAME_FRAG_LEN 50
+#define FRAME_ITERATIONS 100
 
 uint32_t do_test(const uint8_t *key,
 		 uint8_t *nonce, size_t nlen,
@@ -480,6 +486,210 @@ exitTest1:
 	return result;
 }
 
+static const uint8_t stream_frags[] = { 5, 1, 16, 1 };
+
+uint32_t test_stream(void)
+{
+	uint32_t result = TC_PASS;
+	/* RFC 3610 test vector #1, split into fragments */
+	const uint8_t key[NUM_NIST_KEYS] = {
+		0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7,
+		0xc8, 0xc9, 0xca, 0xcb, 0xcc, 0xcd, 0xce, 0xcf
+	};
+	uint8_t nonce[NONCE_LEN] = {
+		0x00, 0x00, 0x00, 0x03, 0x02, 0x01, 0x00, 0xa0,
+		0xa1, 0xa2, 0xa3, 0xa4, 0xa5
+	};
+	const uint8_t hdr[HEADER_LEN] = {
+		0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07
+	};
+	const uint8_t data[DATA_BUF_LEN23] = {
+		0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+		0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+		0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e
+	};
+	const uint8_t expected[EXPECTED_BUF_LEN31] = {
+		0x58, 0x8c, 0x97, 0x9a, 0x61, 0xc6, 0x63, 0xd2,
+		0xf0, 0x66, 0xd0, 0xc2, 0xc0, 0xf9, 0x89, 0x80,
+		0x6d, 0x5f, 0x6b, 0x61, 0xda, 0xc3, 0x84, 0x17,
+		0xe8, 0xd1, 0x2c, 0xfd, 0xf9, 0x26, 0xe0
+	};
+	struct tc_ccm_mode_struct c;
+	struct tc_ccm_stream_struct s;
+	struct tc_aes_key_sched_struct sched;
+	uint8_t buf[EXPECTED_BUF_LEN31];
+	uint16_t mlen = M_LEN8;
+	uint32_t i, pos;
+
+	TC_PRINT("%s: Performing CCM streaming test:\n", __func__);
+
+	tc_aes128_set_encrypt_key(&sched, key);
+	if (tc_ccm_config(&c, &sched, nonce, sizeof(nonce), mlen) == 0) {
+		TC_ERROR("CCM config failed in %s.\n", __func__);
+
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+
+	/* encrypt in place, fragment by fragment */
+	memcpy(buf, data, sizeof(data));
+	if (tc_ccm_stream_init(&s, &c, sizeof(hdr), sizeof(data), 0) == 0 ||
+	    tc_ccm_stream_aad(&s, hdr, 3) == 0 ||
+	    tc_ccm_stream_aad(&s, hdr + 3, sizeof(hdr) - 3) == 0) {
+		TC_ERROR("ccm stream setup failed in %s.\n", __func__);
+
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+
+	for (i = 0, pos = 0; i < sizeof(stream_frags); i++) {
+		if (tc_ccm_stream_update(&s, buf + pos, buf + pos,
+					 stream_frags[i]) == 0) {
+			TC_ERROR("ccm stream encrypt failed in %s.\n",
+				 __func__);
+
+			result = TC_FAIL;
+			goto exitTest1;
+		}
+		pos += stream_frags[i];
+	}
+
+	if (tc_ccm_stream_tag(buf + pos, &s) == 0 ||
+	    memcmp(expected, buf, sizeof(expected)) != 0) {
+		TC_ERROR("ccm stream produced wrong ciphertext in %s.\n",
+			 __func__);
+		show_str("\t\tExpected", expected, sizeof(expected));
+		show_str("\t\tComputed", buf, sizeof(buf));
+
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+
+	/* decrypt in place, fragments in the reverse order of sizes */
+	if (tc_ccm_stream_init(&s, &c, sizeof(hdr), sizeof(data), 1) == 0 ||
+	    tc_ccm_stream_aad(&s, hdr, sizeof(hdr)) == 0) {
+		TC_ERROR("ccm stream setup failed in %s.\n", __func__);
+
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+
+	for (i = sizeof(stream_frags), pos = 0; i > 0; i--) {
+		if (tc_ccm_stream_update(&s, buf + pos, buf + pos,
+					 stream_frags[i - 1]) == 0) {
+			TC_ERROR("ccm stream decrypt failed in %s.\n",
+				 __func__);
+
+			result = TC_FAIL;
+			goto exitTest1;
+		}
+		pos += stream_frags[i - 1];
+	}
+
+	if (tc_ccm_stream_verify(buf + pos, &s) == 0 ||
+	    memcmp(data, buf, sizeof(data)) != 0) {
+		TC_ERROR("ccm stream decryption failed in %s.\n", __func__);
+		show_str("\t\tExpected", data, sizeof(data));
+		show_str("\t\tComputed", buf, sizeof(data));
+
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+
+	/* a modified tag must be rejected */
+	memcpy(buf, expected, sizeof(expected));
+	buf[sizeof(expected) - 1] ^= 1;
+	if (tc_ccm_stream_init(&s, &c, sizeof(hdr), sizeof(data), 1) == 0 ||
+	    tc_ccm_stream_aad(&s, hdr, sizeof(hdr)) == 0 ||
+	    tc_ccm_stream_update(&s, buf, buf, sizeof(data)) == 0 ||
+	    tc_ccm_stream_verify(buf + sizeof(data), &s) != 0) {
+		TC_ERROR("ccm stream accepted a bad tag in %s.\n", __func__);
+
+		result = TC_FAIL;
+		goto exitTest1;
+	}
+
+	result = TC_PASS;
+
+exitTest1:
+	TC_END_RESULT(result);
+	return result;
+}
+
+uint32_t test_frame_cycles(void)
+{
+	uint32_t result = TC_PASS;
+	const uint8_t key[NUM_NIST_KEYS] = {
+		0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7,
+		0xc8, 0xc9, 0xca, 0xcb, 0xcc, 0xcd, 0xce, 0xcf
+	};
+	uint8_t nonce[NONCE_LEN] = { 0 };
+	struct tc_ccm_mode_struct c;
+	struct tc_ccm_stream_struct s;
+	struct tc_aes_key_sched_struct sched;
+	static uint8_t frame[FRAME_LEN + M_LEN8];
+	static uint8_t linear[FRAME_LEN + M_LEN8];
+	uint32_t start, oneshot, stream;
+	uint32_t i, pos, len;
+
+	TC_PRINT("%s: Timing CCM over a %d byte frame:\n", __func__,
+		 FRAME_LEN);
+
+	for (i = 0; i < FRAME_LEN; i++) {
+		frame[i] = i;
+	}
+
+	tc_aes128_set_encrypt_key(&sched, key);
+	(void) tc_ccm_config(&c, &sched, nonce, sizeof(nonce), M_LEN8);
+
+	/* one-shot: the payload first has to be linearized */
+	start = k_cycle_get_32();
+	for (i = 0; i < FRAME_ITERATIONS; i++) {
+		memcpy(linear, frame, FRAME_LEN);
+		(void) tc_ccm_generation_encryption(linear + FRAME_HDR_LEN,
+					linear, FRAME_HDR_LEN,
+					linear + FRAME_HDR_LEN,
+					FRAME_LEN - FRAME_HDR_LEN, &c);
+	}
+	oneshot = (k_cycle_get_32() - start) / FRAME_ITERATIONS;
+
+	/* streaming: in place over fragments of FRAME_FRAG_LEN bytes */
+	start = k_cycle_get_32();
+	for (i = 0; i < FRAME_ITERATIONS; i++) {
+		(void) tc_ccm_stream_init(&s, &c, FRAME_HDR_LEN,
+					  FRAME_LEN - FRAME_HDR_LEN, 0);
+		(void) tc_ccm_stream_aad(&s, frame, FRAME_HDR_LEN);
+		for (pos = FRAME_HDR_LEN; pos < FRAME_LEN; pos += len) {
+			len = FRAME_FRAG_LEN - (pos % FRAME_FRAG_LEN);
+			if (pos + len > FRAME_LEN) {
+				len = FRAME_LEN - pos;
+			}
+			(void) tc_ccm_stream_update(&s, frame + pos,
+						    frame + pos, len);
+		}
+		(void) tc_ccm_stream_tag(frame + FRAME_LEN, &s);
+
+		/* both must agree on the first iteration */
+		if (i == 0 && memcmp(frame + FRAME_HDR_LEN,
+				     linear + FRAME_HDR_LEN,
+				     FRAME_LEN - FRAME_HDR_LEN + M_LEN8)) {
+			TC_ERROR("ccm stream and one-shot differ in %s.\n",
+				 __func__);
+
+			result = TC_FAIL;
+			goto exitTest1;
+		}
+	}
+	stream = (k_cycle_get_32() - start) / FRAME_ITERATIONS;
+
+	TC_PRINT("\tone-shot %u cycles, streaming %u cycles per frame\n",
+		 oneshot, stream);
+
+exitTest1:
+	TC_END_RESULT(result);
+	return result;
+}
+
 /*
  * Main task to test CCM
  */
@@ -530,6 +740,16 @@ void main(void)
 		TC_ERROR("CCM test #8 (no payload data) failed.\n");
 		goto exitTest;
 	}
+	result = test_stream();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("CCM streaming test failed.\n");
+		goto exitTest;
+	}
+	result = test_frame_cycles();
+	if (result == TC_FAIL) { /* terminate test */
+		TC_ERROR("CCM frame timing test failed.\n");
+		goto exitTest;
+	}
 
 	TC_PRINT("All CCM tests succeeded!\n");
 
@@ -53,6 +53,8 @@
 #include "mbedtls/bignum.h"
 #include "mbedtls/rsa.h"
 #include "mbedtls/x509.h"
+#include "mbedtls/x509_crt.h"
+#include "mbedtls/certs.h"
 #include "mbedtls/xtea.h"
 #include "mbedtls/pkcs5.h"
 #include "mbedtls/ecp.h"
@@ -157,9 +159,108 @@ static void create_entropy_seed_file(void)
 unsigned char buf[16384];
 #endif
 
+#if defined(MBEDTLS_SELF_TEST) && defined(MBEDTLS_BIGNUM_C)
+/*
+ * Report how long a public key suite took; those are dominated by the
+ * bignum multiply-accumulate kernels in bn_mul.h.
+ */
+static void print_elapsed(const char *name, uint32_t start)
+{
+	uint32_t cycles = k_cycle_get_32() - start;
+
+	mbedtls_printf("  %s self-test: %u cycles (%u us)\n\n", name, cycles,
+		       (uint32_t)(SYS_CLOCK_HW_CYCLES_TO_NS64(cycles) / 1000));
+}
+#endif
+
+#if defined(MBEDTLS_SELF_TEST) && defined(MBEDTLS_X509_CRT_PARSE_C) && \
+	defined(MBEDTLS_PEM_PARSE_C) && defined(MBEDTLS_CERTS_C) && \
+	defined(MBEDTLS_MEMORY_BUFFER_ALLOC_C) && defined(MBEDTLS_MEMORY_DEBUG)
+static unsigned char crt_buf[4096];
+
+/*
+ * Heap used at peak while parsing, on top of what was already allocated
+ */
+static size_t peak_heap(size_t base)
+{
+	size_t max_used, max_blocks;
+
+	mbedtls_memory_buffer_alloc_max_get(&max_used, &max_blocks);
+
+	return max_used - base;
+}
+
+/*
+ * Parse the test CA both the usual way and in place, and compare the peak
+ * heap usage; the in-place parser must not allocate the DER data.
+ */
+static int x509_inplace_test(int verbose)
+{
+	mbedtls_x509_crt copy, inplace;
+	size_t base, blocks, copy_peak, inplace_peak;
+	int ret = 1;
+
+	if (mbedtls_test_ca_crt_len > sizeof(crt_buf)) {
+		return 1;
+	}
+
+	memcpy(crt_buf, mbedtls_test_ca_crt, mbedtls_test_ca_crt_len);
+
+	mbedtls_x509_crt_init(&copy);
+	mbedtls_x509_crt_init(&inplace);
+
+	mbedtls_memory_buffer_alloc_cur_get(&base, &blocks);
+	mbedtls_memory_buffer_alloc_max_reset();
+	if (mbedtls_x509_crt_parse(&copy,
+				   (const unsigned char *)mbedtls_test_ca_crt,
+				   mbedtls_test_ca_crt_len) != 0) {
+		goto exit;
+	}
+	copy_peak = peak_heap(base);
+
+	mbedtls_memory_buffer_alloc_cur_get(&base, &blocks);
+	mbedtls_memory_buffer_alloc_max_reset();
+	if (mbedtls_x509_crt_parse_inplace(&inplace, crt_buf,
+					   mbedtls_test_ca_crt_len) != 0) {
+		goto exit;
+	}
+	inplace_peak = peak_heap(base);
+
+	if (verbose != 0) {
+		mbedtls_printf("  X.509 PEM peak heap: %zu bytes copied, "
+			       "%zu bytes in place (DER %zu bytes)\n",
+			       copy_peak, inplace_peak, inplace.raw.len);
+	}
+
+	if (inplace.raw.p < crt_buf ||
+	    inplace.raw.p + inplace.raw.len > crt_buf + sizeof(crt_buf) ||
+	    inplace.raw.len != copy.raw.len ||
+	    memcmp(inplace.raw.p, copy.raw.p, copy.raw.len) != 0 ||
+	    inplace_peak + inplace.raw.len > copy_peak) {
+		goto exit;
+	}
+
+	ret = 0;
+
+exit:
+	if (verbose != 0) {
+		mbedtls_printf("  X.509 in-place parse: %s\n\n",
+			       ret ? "failed" : "passed");
+	}
+
+	mbedtls_x509_crt_free(&copy);
+	mbedtls_x509_crt_free(&inplace);
+
+	return ret;
+}
+#endif
+
 int main(void)
 {
 	int v, suites_tested = 0, suites_failed = 0;
+#if defined(MBEDTLS_SELF_TEST) && defined(MBEDTLS_BIGNUM_C)
+	uint32_t start;
+#endif
 
 	void *pointer;
 
@@ -287,16 +388,20 @@ int main(void)
 #endif
 
 #if defined(MBEDTLS_BIGNUM_C)
+	start = k_cycle_get_32();
 	if (mbedtls_mpi_self_test(v) != 0) {
 		suites_failed++;
 	}
+	print_elapsed("MPI", start);
 	suites_tested++;
 #endif
 
 #if defined(MBEDTLS_RSA_C)
+	start = k_cycle_get_32();
 	if (mbedtls_rsa_self_test(v) != 0) {
 		suites_failed++;
 	}
+	print_elapsed("RSA", start);
 	suites_tested++;
 #endif
 
@@ -307,6 +412,15 @@ int main(void)
 	suites_tested++;
 #endif
 
+#if defined(MBEDTLS_X509_CRT_PARSE_C) && defined(MBEDTLS_PEM_PARSE_C) && \
+	defined(MBEDTLS_CERTS_C) && defined(MBEDTLS_MEMORY_BUFFER_ALLOC_C) && \
+	defined(MBEDTLS_MEMORY_DEBUG)
+	if (x509_inplace_test(v) != 0) {
+		suites_failed++;
+	}
+	suites_tested++;
+#endif
+
 #if defined(MBEDTLS_XTEA_C)
 	if (mbedtls_xtea_self_test(v) != 0) {
 		suites_failed++;
@@ -336,9 +450,11 @@ int main(void)
 #endif
 
 #if defined(MBEDTLS_ECP_C)
+	start = k_cycle_get_32();
 	if (mbedtls_ecp_self_test(v) != 0) {
 		suites_failed++;
 	}
+	print_elapsed("ECP", start);
 	suites_tested++;
 #endif
 
@@ -350,9 +466,11 @@ int main(void)
 #endif
 
 #if defined(MBEDTLS_DHM_C)
+	start = k_cycle_get_32();
 	if (mbedtls_dhm_self_test(v) != 0) {
 		suites_failed++;
 	}
+	print_elapsed("DHM", start);
 	suites_tested++;
 #endif
 
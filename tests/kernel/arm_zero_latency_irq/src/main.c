@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ *
+ * Connect a zero latency IRQ and a regular direct IRQ, then check that with
+ * interrupts locked the former still runs and the latter waits for
+ * irq_unlock(). Then measure the worst-case latency of the zero latency IRQ
+ * with interrupts locked.
+ *
+ * The zero latency ISR may not call k_cycle_get_32(), the latency is
+ * read from the SysTick counter instead.
+ */
+
+#if !defined(CONFIG_CPU_CORTEX_M)
+  #error project can only run on Cortex-M
+#endif
+
+#include <ztest.h>
+#include <arch/cpu.h>
+#include <arch/arm/cortex_m/cmsis.h>
+
+#define ZLI_IRQ		(CONFIG_NUM_IRQS - 1)
+#define REGULAR_IRQ	(CONFIG_NUM_IRQS - 2)
+
+#define LATENCY_LOOPS	1000
+
+static volatile uint32_t zli_count;
+static volatile uint32_t zli_systick;
+static volatile uint32_t regular_count;
+
+ISR_ZERO_LATENCY_DECLARE(zli_isr)
+{
+	zli_systick = SysTick->VAL;
+	zli_count++;
+}
+
+ISR_DIRECT_DECLARE(regular_isr)
+{
+	regular_count++;
+	return 0;
+}
+
+static void trigger_irq(int irq)
+{
+#if defined(CONFIG_SOC_TI_LM3S6965_QEMU)
+	/* QEMU does not simulate the STIR register: this is a workaround */
+	NVIC_SetPendingIRQ(irq);
+#else
+	NVIC->STIR = irq;
+#endif
+	__DSB();
+	__ISB();
+}
+
+/* SysTick counts down from its reload value */
+static uint32_t systick_elapsed(uint32_t start, uint32_t end)
+{
+	if (start >= end) {
+		return start - end;
+	}
+
+	return start + SysTick->LOAD + 1 - end;
+}
+
+void test_zli_not_masked(void)
+{
+	unsigned int key;
+	uint32_t count = zli_count;
+
+	key = irq_lock();
+
+	trigger_irq(ZLI_IRQ);
+	trigger_irq(REGULAR_IRQ);
+
+	assert_equal(zli_count, count + 1, "zero latency IRQ was masked");
+	assert_equal(regular_count, 0, "regular IRQ was not masked");
+
+	irq_unlock(key);
+
+	assert_equal(regular_count, 1, "regular IRQ did not run");
+}
+
+void test_zli_latency(void)
+{
+	unsigned int key;
+	uint32_t start, count, latency, worst = 0;
+	int i;
+
+	key = irq_lock();
+
+	for (i = 0; i < LATENCY_LOOPS; i++) {
+		count = zli_count;
+		start = SysTick->VAL;
+		trigger_irq(ZLI_IRQ);
+
+		/* Without a new sample zli_systick is stale */
+		if (zli_count != count + 1) {
+			break;
+		}
+
+		latency = systick_elapsed(start, zli_systick);
+		if (latency > worst) {
+			worst = latency;
+		}
+	}
+
+	irq_unlock(key);
+
+	assert_equal(i, LATENCY_LOOPS, "zero latency IRQ did not run");
+
+	/* Only reported: under QEMU SysTick follows host time */
+	printk("zero latency IRQ worst-case latency: %u cycles\n", worst);
+}
+
+void test_main(void)
+{
+	IRQ_DIRECT_CONNECT(ZLI_IRQ, 0, zli_isr, IRQ_ZERO_LATENCY);
+	IRQ_DIRECT_CONNECT(REGULAR_IRQ, 0, regular_isr, 0);
+	irq_enable(ZLI_IRQ);
+	irq_enable(REGULAR_IRQ);
+
+	ztest_test_suite(zero_latency_irq_test,
+			 ztest_unit_test(test_zli_not_masked),
+			 ztest_unit_test(test_zli_latency));
+
+	ztest_run_test_suite(zero_latency_irq_test);
+}
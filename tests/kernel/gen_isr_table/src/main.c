@@ -38,6 +38,9 @@ extern uint32_t _irq_vector_table[];
 #define ISR4_ARG	0xca55e77e
 static volatile int trigger_check[TRIG_CHECK_SIZE];
 
+/* Cycle count upon ISR entry, for the interrupt latency */
+static volatile uint32_t isr_cycles[TRIG_CHECK_SIZE];
+
 #if defined(CONFIG_ARM)
 #include <arch/arm/cortex_m/cmsis.h>
 
@@ -64,9 +67,15 @@ void trigger_irq(int irq)
 #define NO_TRIGGER_FROM_SW
 #endif
 
+#if defined(CONFIG_RISCV_NESTED_IRQ) && !defined(NO_TRIGGER_FROM_SW)
+#define TEST_NESTED_IRQS
+static volatile int isr4_preempted;
+#endif
+
 #ifdef HAS_DIRECT_IRQS
 ISR_DIRECT_DECLARE(isr1)
 {
+	isr_cycles[ISR1_OFFSET] = k_cycle_get_32();
 	printk("isr1 ran\n");
 	trigger_check[ISR1_OFFSET]++;
 	return 0;
@@ -74,6 +83,7 @@ ISR_DIRECT_DECLARE(isr1)
 
 ISR_DIRECT_DECLARE(isr2)
 {
+	isr_cycles[ISR2_OFFSET] = k_cycle_get_32();
 	printk("isr2 ran\n");
 	trigger_check[ISR2_OFFSET]++;
 	return 1;
@@ -82,6 +92,7 @@ ISR_DIRECT_DECLARE(isr2)
 
 void isr3(void *param)
 {
+	isr_cycles[ISR3_OFFSET] = k_cycle_get_32();
 	printk("isr3 ran with parameter %p\n", param);
 	trigger_check[ISR3_OFFSET]++;
 }
@@ -89,14 +100,29 @@ void isr3(void *param)
 
 void isr4(void *param)
 {
+#ifdef TEST_NESTED_IRQS
+	int isr3_runs;
+#endif
+
+	isr_cycles[ISR4_OFFSET] = k_cycle_get_32();
 	printk("isr4 ran with parameter %p\n", param);
 	trigger_check[ISR4_OFFSET]++;
+
+#ifdef TEST_NESTED_IRQS
+	/* isr3 is more urgent, it has to run before this ISR returns */
+	isr3_runs = trigger_check[ISR3_OFFSET];
+	trigger_irq(IRQ_LINE(ISR3_OFFSET));
+	isr4_preempted = (trigger_check[ISR3_OFFSET] != isr3_runs);
+#endif
 }
 
 int test_irq(int offset)
 {
 #ifndef NO_TRIGGER_FROM_SW
+	uint32_t start;
+
 	TC_PRINT("triggering irq %d\n", IRQ_LINE(offset));
+	start = k_cycle_get_32();
 	trigger_irq(IRQ_LINE(offset));
 	if (trigger_check[offset] != 1) {
 		TC_PRINT("interrupt %d didn't run once, ran %d times\n",
@@ -104,6 +130,8 @@ int test_irq(int offset)
 			 trigger_check[offset]);
 		return -1;
 	}
+	TC_PRINT("interrupt %d latency %u cycles\n", IRQ_LINE(offset),
+		 isr_cycles[offset] - start);
 #else
 	/* This arch doesn't support triggering interrupts from software */
 	ARG_UNUSED(offset);
@@ -215,6 +243,14 @@ void main(void)
 		rv = TC_FAIL;
 		goto done;
 	}
+
+#ifdef TEST_NESTED_IRQS
+	if (!isr4_preempted) {
+		TC_PRINT("isr3 did not preempt isr4\n");
+		rv = TC_FAIL;
+		goto done;
+	}
+#endif
 #endif
 
 	rv = TC_PASS;
@@ -15,6 +15,12 @@
 extern struct net_buf *current_buf;
 extern struct k_sem driver_lock;
 
+static enum ieee802154_hw_caps fake_get_capabilities(struct device *dev)
+{
+	/* Leave CSMA-CA and ACK handling to the L2 under test */
+	return 0;
+}
+
 static int fake_cca(struct device *dev)
 {
 	return 0;
@@ -131,6 +137,8 @@ static struct ieee802154_radio_api fake_radio_api = {
 	.iface_api.init	= fake_iface_init,
 	.iface_api.send	= ieee802154_radio_send,
 
+	.get_capabilities	= fake_get_capabilities,
+
 	.cca		= fake_cca,
 	.set_channel	= fake_set_channel,
 	.set_pan_id	= fake_set_pan_id,
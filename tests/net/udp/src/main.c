@@ -581,9 +581,185 @@ static bool run_tests(void)
 	return true;
 }
 
+/* Connections registered for the lookup benchmark, leaving one for the
+ * wildcard listener.
+ */
+#define BENCH_CONNS	(CONFIG_NET_MAX_CONN - 1)
+#define BENCH_ROUNDS	200
+#define BENCH_LPORT	5000
+#define BENCH_RPORT	20000
+
+/* With net debugging on, the timings mostly measure console output, only
+ * the delivery checks are meaningful then (see prj_bench.conf).
+ */
+#if defined(CONFIG_NET_DEBUG_CORE) || defined(CONFIG_NET_DEBUG_CONN) || \
+	defined(CONFIG_NET_DEBUG_UDP)
+#define BENCH_REPORT	0
+#else
+#define BENCH_REPORT	1
+#endif
+
+static struct ud bench_ud[BENCH_CONNS];
+static struct ud bench_any_ud;
+
+/* Unlike send_ipv6_udp_msg(), a packet which is not delivered is a
+ * failure, and it must reach the handler registered with ud.
+ */
+static bool bench_send(struct net_if *iface, struct in6_addr *peer,
+		       struct in6_addr *my, uint16_t remote_port,
+		       struct ud *ud)
+{
+	struct net_buf *buf;
+	struct net_buf *frag;
+	int ret;
+
+	buf = net_nbuf_get_reserve_tx(0, K_FOREVER);
+	frag = net_nbuf_get_reserve_data(0, K_FOREVER);
+	net_buf_frag_add(buf, frag);
+
+	net_nbuf_set_iface(buf, iface);
+	net_nbuf_set_ll_reserve(buf, net_buf_headroom(frag));
+
+	setup_ipv6_udp(buf, peer, my, remote_port, BENCH_LPORT);
+
+	returned_ud = NULL;
+
+	ret = net_recv_data(iface, buf);
+	if (ret < 0) {
+		printk("Cannot recv buf %p, ret %d\n", buf, ret);
+		return false;
+	}
+
+	if (k_sem_take(&recv_lock, TIMEOUT)) {
+		printk("Timeout, packet from port %u not received\n",
+		       remote_port);
+		return false;
+	}
+
+	if (fail || returned_ud != ud) {
+		printk("Packet from port %u delivered to %p, expected %p\n",
+		       remote_port, returned_ud, ud);
+		return false;
+	}
+
+	return true;
+}
+
+/* Average time from net_recv_data() to the handler, round robin over the
+ * first count exact connections so that the connection cache keeps missing.
+ */
+static bool bench_deliver(struct net_if *iface, struct in6_addr *peer,
+			  struct in6_addr *my, int count, uint32_t *avg_us)
+{
+	uint32_t start;
+	int r, n;
+
+	start = k_cycle_get_32();
+
+	for (r = 0; r < BENCH_ROUNDS; r++) {
+		n = (r * 7) % count;
+
+		if (!bench_send(iface, peer, my, BENCH_RPORT + n,
+				&bench_ud[n])) {
+			return false;
+		}
+	}
+
+	*avg_us = (uint32_t)(SYS_CLOCK_HW_CYCLES_TO_NS64(k_cycle_get_32() -
+							  start) /
+			     (NSEC_PER_USEC * BENCH_ROUNDS));
+
+	return true;
+}
+
+static bool run_lookup_benchmark(void)
+{
+	struct net_conn_handle *any_handle;
+	struct net_conn_handle *handles[BENCH_CONNS];
+	struct net_if *iface = net_if_get_default();
+	struct in6_addr in6addr_my = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+					   0, 0, 0, 0, 0, 0, 0, 0x1 } } };
+	struct in6_addr in6addr_peer = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0,
+					     0, 0, 0, 0, 0x4e, 0x11, 0, 0,
+					     0x2 } } };
+	struct sockaddr_in6 peer_addr6 = { 0 };
+	struct sockaddr_in6 my_addr6 = { 0 };
+	uint32_t one_us, full_us;
+	bool st = true;
+	int ret, i;
+
+	peer_addr6.sin6_family = AF_INET6;
+	net_ipaddr_copy(&peer_addr6.sin6_addr, &in6addr_peer);
+	my_addr6.sin6_family = AF_INET6;
+	net_ipaddr_copy(&my_addr6.sin6_addr, &in6addr_my);
+
+	/* Wildcard listener on the same port, which must lose against
+	 * every exact match below.
+	 */
+	ret = net_udp_register(NULL, NULL, 0, BENCH_LPORT, test_ok,
+			       &bench_any_ud, &any_handle);
+	if (ret) {
+		printk("UDP register wildcard failed (%d)\n", ret);
+		return false;
+	}
+
+	ret = net_udp_register((struct sockaddr *)&peer_addr6,
+			       (struct sockaddr *)&my_addr6,
+			       BENCH_RPORT, BENCH_LPORT, test_ok,
+			       &bench_ud[0], &handles[0]);
+	if (ret) {
+		printk("UDP register benchmark 0 failed (%d)\n", ret);
+		net_udp_unregister(any_handle);
+		return false;
+	}
+
+	if (!bench_deliver(iface, &in6addr_peer, &in6addr_my, 1, &one_us)) {
+		printk("UDP lookup benchmark delivery failed\n");
+		st = false;
+	}
+
+	for (i = 1; st && i < BENCH_CONNS; i++) {
+		ret = net_udp_register((struct sockaddr *)&peer_addr6,
+				       (struct sockaddr *)&my_addr6,
+				       BENCH_RPORT + i, BENCH_LPORT, test_ok,
+				       &bench_ud[i], &handles[i]);
+		if (ret) {
+			printk("UDP register benchmark %d failed (%d)\n",
+			       i, ret);
+			st = false;
+			break;
+		}
+	}
+
+	if (st) {
+		st = bench_deliver(iface, &in6addr_peer, &in6addr_my,
+				   BENCH_CONNS, &full_us);
+
+		/* Unknown remote port falls back to the listener */
+		st = st && bench_send(iface, &in6addr_peer, &in6addr_my,
+				      BENCH_RPORT - 1, &bench_any_ud);
+
+		if (!st) {
+			printk("UDP lookup benchmark delivery failed\n");
+		} else if (BENCH_REPORT) {
+			printk("UDP lookup: %u us/pkt with 1 connection, "
+			       "%u us/pkt with %d connections\n",
+			       one_us, full_us, BENCH_CONNS);
+		}
+	}
+
+	while (i--) {
+		net_udp_unregister(handles[i]);
+	}
+
+	net_udp_unregister(any_handle);
+
+	return st;
+}
+
 void main_thread(void)
 {
-	if (run_tests()) {
+	if (run_tests() && run_lookup_benchmark()) {
 		TC_END_REPORT(TC_PASS);
 	} else {
 		TC_END_REPORT(TC_FAIL);
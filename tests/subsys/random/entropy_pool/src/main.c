@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2017 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <entropy_pool.h>
+
+#define THROUGHPUT_BYTES 4096
+
+static uint8_t buffer[THROUGHPUT_BYTES];
+
+static bool all_zero(const uint8_t *buf, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		if (buf[i]) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void test_get_sizes(void)
+{
+	static const size_t sizes[] = { 1, 7, 16, 64, 300 };
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(sizes); i++) {
+		memset(buffer, 0, sizes[i]);
+		assert_equal(entropy_pool_get(buffer, sizes[i], K_FOREVER), 0,
+			     "entropy_pool_get failed");
+
+		if (sizes[i] >= 7) {
+			assert_false(all_zero(buffer, sizes[i]),
+				     "no entropy returned");
+		}
+	}
+}
+
+void test_no_reuse(void)
+{
+	uint8_t first[32], second[32];
+
+	assert_equal(entropy_pool_get(first, sizeof(first), K_FOREVER), 0,
+		     "entropy_pool_get failed");
+	assert_equal(entropy_pool_get(second, sizeof(second), K_FOREVER), 0,
+		     "entropy_pool_get failed");
+
+	assert_true(memcmp(first, second, sizeof(first)) != 0,
+		    "the same bytes were handed out twice");
+}
+
+void test_throughput(void)
+{
+	struct entropy_pool_stats stats;
+	uint32_t start, cycles;
+
+	start = k_cycle_get_32();
+	assert_equal(entropy_pool_get(buffer, sizeof(buffer), K_FOREVER), 0,
+		     "entropy_pool_get failed");
+	cycles = k_cycle_get_32() - start;
+
+	entropy_pool_stats_get(&stats);
+	TC_PRINT("%d bytes in %u us, harvested %u discarded %u served %u\n",
+		 THROUGHPUT_BYTES,
+		 (uint32_t)(SYS_CLOCK_HW_CYCLES_TO_NS64(cycles) / NSEC_PER_USEC),
+		 stats.harvested, stats.discarded, stats.served);
+
+	assert_true(stats.served <= stats.harvested,
+		    "served more than was harvested");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(entropy_pool_test,
+			 ztest_unit_test(test_get_sizes),
+			 ztest_unit_test(test_no_reuse),
+			 ztest_unit_test(test_throughput)
+			 );
+
+	ztest_run_test_suite(entropy_pool_test);
+}